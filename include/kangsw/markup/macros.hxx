@@ -2,9 +2,23 @@
 #include "reflection/static_object_base.hxx"
 #include "reflection/property_proxy.hxx"
 
+/**
+ * Lookup hook for type names. Nested object types find name of their enclosing object type
+ *through static_object_base, otherwise this fallback which yields empty name.
+ */
+inline ::kangsw::refl::u8str cppmarkup_enclosing_type_name() { return {}; }
+
+// INTERNAL_CPPMARKUP_OBJECT_TEMPLATE_NAMED(object_type, name_expr)
+#define INTERNAL_CPPMARKUP_OBJECT_TEMPLATE_NAMED(object_type, name_expr)                   \
+    struct object_type##_internal_TYPE_NAME {                                             \
+        static ::kangsw::refl::u8str get() { return name_expr; }                          \
+    };                                                                                    \
+    struct object_type : ::kangsw::refl::static_object_base<object_type, object_type##_internal_TYPE_NAME>
+
 // INTERNAL_CPPMARKUP_OBJECT_TEMPLATE(object_type)
 #define INTERNAL_CPPMARKUP_OBJECT_TEMPLATE(object_type) \
-    struct object_type : ::kangsw::refl::static_object_base<object_type>
+    INTERNAL_CPPMARKUP_OBJECT_TEMPLATE_NAMED(           \
+      object_type, ::kangsw::refl::_internal::qualify_type_name(cppmarkup_enclosing_type_name(), #object_type))
 
 // INTERNAL_CPPMARKUP_ELEMENT(elem_var, elem_name, default_value, flags)
 // INTERNAL_CPPMARKUP_ELEMENT_WITH_ATTR(elem_var, elem_name, default_value, flags, ...)
@@ -78,15 +92,20 @@
     static inline const auto _##elem_var##_DEFAULT_VALUE = []() { return default_value; };   \
     INTERNAL_CPPMAKRUP_ENTITY_latter(elem_var, flags)
 
+// embedded object types are named after their element.
+#define INTERNAL_CPPMARKUP_EMBED_OBJECT_TEMPLATE(elem_var) \
+    INTERNAL_CPPMARKUP_OBJECT_TEMPLATE_NAMED(             \
+      _##elem_var##_VALUE_TYPE, ::kangsw::refl::_internal::qualify_type_name(cppmarkup_enclosing_type_name(), #elem_var))
+
 #define INTERNAL_CPPMARKUP_EMBED_OBJECT_begin_ATTR(elem_var, elem_name, flags, ...) \
     static constexpr auto _##elem_var##_FLAGS = flags;                              \
     INTERNAL_CPPMARKUP_ENTITY_former_ATTR(elem_var, elem_name, ##__VA_ARGS__);      \
-    INTERNAL_CPPMARKUP_OBJECT_TEMPLATE(_##elem_var##_VALUE_TYPE)
+    INTERNAL_CPPMARKUP_EMBED_OBJECT_TEMPLATE(elem_var)
 
 #define INTERNAL_CPPMARKUP_EMBED_OBJECT_begin_NOATTR(elem_var, elem_name, flags) \
     static constexpr auto _##elem_var##_FLAGS = flags;                           \
     INTERNAL_CPPMARKUP_ENTITY_former_NOATTR(elem_var, elem_name);                \
-    INTERNAL_CPPMARKUP_OBJECT_TEMPLATE(_##elem_var##_VALUE_TYPE)
+    INTERNAL_CPPMARKUP_EMBED_OBJECT_TEMPLATE(elem_var)
 
 #define INTERNAL_CPPMARKUP_EMBED_OBJECT_end(elem_var)           \
     ;                                                           \
@@ -94,6 +113,14 @@
       []() { return _##elem_var##_VALUE_TYPE::get_default(); }; \
     INTERNAL_CPPMAKRUP_ENTITY_latter(elem_var, _##elem_var##_FLAGS)
 
+// INTERNAL_CPPMARKUP_TRACK_CHANGES()
+#define INTERNAL_CPPMARKUP_TRACK_CHANGES()                                                      \
+    mutable ::kangsw::refl::object_state _internal_STATE;                                       \
+                                                                                                \
+    static size_t _internal_STATE_OFFSET() { return offsetof(self_type, _internal_STATE); }     \
+    static inline ::kangsw::refl::state_registration_t<self_type> _internal_STATE_REGISTER{     \
+      _internal_STATE_OFFSET()}
+
 namespace kangsw::refl::_internal {
 template <typename DTy_, typename Ty_, typename... Args_>
 auto _deduce_map_impl(u8str_map<DTy_>& acc, u8str_view a, Ty_&& b, [[maybe_unused]] Args_&&... args) {
@@ -128,7 +155,8 @@ constexpr char const* to_cstr(char const (&str)[N])
 #define INTERNAL_CPPMARKUP_MAP(...) ::kangsw::refl::_internal::deduce_map(__VA_ARGS__)
 #define CPPMARKUP_MAP(...)          INTERNAL_CPPMARKUP_MAP(__VA_ARGS__)
 
-#define CPPMARKUP_OBJECT_TEMPLATE(objtype) INTERNAL_CPPMARKUP_OBJECT_TEMPLATE(objtype)
+#define CPPMARKUP_OBJECT_TEMPLATE(objtype)             INTERNAL_CPPMARKUP_OBJECT_TEMPLATE(objtype)
+#define CPPMARKUP_NAMED_OBJECT_TEMPLATE(objtype, name) INTERNAL_CPPMARKUP_OBJECT_TEMPLATE_NAMED(objtype, name)
 
 #define CPPMARKUP_ELEMENT_AF(tag, default_value, flags, ...) INTERNAL_CPPMARKUP_ELEMENT_ATTR(tag, ::kangsw::refl::_internal::to_cstr(u8## #tag), default_value, flags, ##__VA_ARGS__);
 #define CPPMARKUP_ELEMENT_A(tag, default_value, ...)         INTERNAL_CPPMARKUP_ELEMENT_ATTR(tag, ::kangsw::refl::_internal::to_cstr(u8## #tag), default_value, 0, ##__VA_ARGS__);
@@ -142,6 +170,8 @@ constexpr char const* to_cstr(char const (&str)[N])
 #define CPPMARKUP_EMBED_OBJECT_begin(tag)                INTERNAL_CPPMARKUP_EMBED_OBJECT_begin_NOATTR(tag, ::kangsw::refl::_internal::to_cstr(u8## #tag), 0)
 #define CPPMARKUP_EMBED_OBJECT_end(tag)                  INTERNAL_CPPMARKUP_EMBED_OBJECT_end(tag)
 
+#define CPPMARKUP_TRACK_CHANGES() INTERNAL_CPPMARKUP_TRACK_CHANGES();
+
 // #define CPPMARKUP_EMBED_OBJECT_AF_begin(tag, flags, ...) INTERNAL_CPPMARKUP_EMBED_OBJECT_begin_ATTR(tag, ::kangsw::refl::_internal::to_cstr(u8## #tag), flags, __VA_ARGS__)
 // #define CPPMARKUP_EMBED_OBJECT_A_begin(tag, ...)         INTERNAL_CPPMARKUP_EMBED_OBJECT_begin_ATTR(tag, ::kangsw::refl::_internal::to_cstr(u8## #tag), 0, __VA_ARGS__)
 // #define CPPMARKUP_EMBED_OBJECT_F_begin(tag, flags)       INTERNAL_CPPMARKUP_EMBED_OBJECT_begin_NOATTR(tag, ::kangsw::refl::_internal::to_cstr(u8## #tag), flags)
@@ -1,26 +1,144 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
 #include <optional>
 #include "kangsw/markup/types.hxx"
+#include "kangsw/markup/reflection/property.hxx"
+
+namespace kangsw {
+class thread_pool;
+}
 
 namespace kangsw::refl::marshal {
 
+/** Representation of timestamps in marshaled documents */
+enum class timestamp_encoding : uint8_t {
+    iso8601,  // RFC 3339 string, i.e. "2021-03-04T05:06:07.890Z"
+    epoch_ms, // integer milliseconds since 1970-01-01T00:00:00Z
+    epoch_us, // integer microseconds
+    epoch_ns, // integer nanoseconds
+};
+
+/** Timestamp encoding of given property; its flag overrides the encoding of marshaling call. */
+inline timestamp_encoding timestamp_encoding_of(property const& prop, timestamp_encoding fallback) {
+    auto const flag = prop.flags() & property_flag::timestamp_encoding_mask;
+    return flag ? timestamp_encoding(flag - 1) : fallback;
+}
+
+/** Representation of binary chunks in marshaled documents */
+enum class binary_encoding : uint8_t {
+    base64,  // padded base64 string
+    hex,     // lowercase hexadecimal string; either case is accepted
+    base85,  // Z85 alphabet, of which the last group may be partial
+    sidecar, // "offset:length" string which refers to blob of external stream
+};
+
+/** Binary encoding of given property; its flag overrides the encoding of marshaling call. */
+inline binary_encoding binary_encoding_of(property const& prop, binary_encoding fallback) {
+    auto const flag = (prop.flags() & property_flag::binary_encoding_mask) >> 3;
+    return flag ? binary_encoding(flag - 1) : fallback;
+}
+
+/** Identifies pair of value encodings, i.e. which raw value deferred by parser was written in. */
+inline int64_t encoding_key(timestamp_encoding timestamps, binary_encoding binaries) {
+    return int64_t(binaries) << 2 | int64_t(timestamps);
+}
+
+/** Appends blob of sidecar encoded binary into external stream, and returns its offset. */
+using sidecar_writer_t = std::function<uint64_t(void const* data, size_t size)>;
+
+/** Reads blob of external stream at offset into out. Returns false if it is out of range. */
+using sidecar_reader_t = std::function<bool(uint64_t offset, size_t size, void* out)>;
+
+inline int64_t to_epoch(timestamp_t t, timestamp_encoding encoding) {
+    using namespace std::chrono;
+    switch (encoding) {
+        case timestamp_encoding::epoch_us: return floor<microseconds>(t.time_since_epoch()).count();
+        case timestamp_encoding::epoch_ns: return floor<nanoseconds>(t.time_since_epoch()).count();
+        default: return floor<milliseconds>(t.time_since_epoch()).count();
+    }
+}
+
+inline timestamp_t from_epoch(int64_t value, timestamp_encoding encoding) {
+    using namespace std::chrono;
+    switch (encoding) {
+        case timestamp_encoding::epoch_us: return timestamp_t{duration_cast<timestamp_t::duration>(microseconds{value})};
+        case timestamp_encoding::epoch_ns: return timestamp_t{duration_cast<timestamp_t::duration>(nanoseconds{value})};
+        default: return timestamp_t{duration_cast<timestamp_t::duration>(milliseconds{value})};
+    }
+}
+
+/**
+ * Layouts of dumped documents. Runtime policy takes indentation width on construction, of which
+ *negative one omits line breaks, and always separates with trailing spaces. The others fix their
+ *layout at compile time; minified one writes no whitespace at all.
+ */
+namespace print_policy {
+struct runtime {
+    static constexpr int id       = 0;
+    static constexpr int width    = -1;
+    static constexpr char fill    = ' ';
+    static constexpr bool fixed   = false;
+    static constexpr char comma[] = ", ";
+    static constexpr char colon[] = ": ";
+};
+
+struct minified {
+    static constexpr int id       = 1;
+    static constexpr int width    = -1;
+    static constexpr char fill    = ' ';
+    static constexpr bool fixed   = true;
+    static constexpr char comma[] = ",";
+    static constexpr char colon[] = ":";
+};
+
+template <int Width_>
+struct spaces {
+    static_assert(Width_ >= 0);
+    static constexpr int id       = 2;
+    static constexpr int width    = Width_;
+    static constexpr char fill    = ' ';
+    static constexpr bool fixed   = true;
+    static constexpr char comma[] = ",";
+    static constexpr char colon[] = ": ";
+};
+
+struct tabs {
+    static constexpr int id       = 3;
+    static constexpr int width    = 1;
+    static constexpr char fill    = '\t';
+    static constexpr bool fixed   = true;
+    static constexpr char comma[] = ",";
+    static constexpr char colon[] = ": ";
+};
+} // namespace print_policy
+
 /**
  * Generic string output
  */
 struct indent_t {};
 constexpr inline static indent_t break_indent;
 
-class string_output {
+template <typename Policy_>
+class basic_string_output {
+public:
+    using policy = Policy_;
+
 public:
-    string_output(u8str& str, int indent_width = -1, int initial_indent = 0)
-      : _out(&str), _indent_width(indent_width), _indent_init(initial_indent) {}
+    /** Indentation width can be given only to runtime policy. */
+    basic_string_output(u8str& str, int indent_width = Policy_::width, int initial_indent = 0)
+      : _out(&str), _indent_width(indent_width), _indent_init(initial_indent) {
+        assert(!Policy_::fixed || indent_width == Policy_::width);
+    }
 
     template <typename Ty_>
-    string_output& operator<<(Ty_&& other) { return *_out += std::forward<Ty_>(other), *this; }
-    string_output& operator<<(indent_t) { return _break_indent(), *this; }
+    basic_string_output& operator<<(Ty_&& other) { return *_out += std::forward<Ty_>(other), *this; }
+    basic_string_output& operator<<(indent_t) { return _break_indent(), *this; }
 
     template <typename Wrap_, typename... Ty_>
-    string_output& wrap(Wrap_&& s, Ty_&&... other) { return *this << s, ((*this << std::forward<Ty_>(other)), ...) << std::forward<Wrap_>(s); }
+    basic_string_output& wrap(Wrap_&& s, Ty_&&... other) { return *this << s, ((*this << std::forward<Ty_>(other)), ...) << std::forward<Wrap_>(s); }
 
     auto& str() const { return *_out; }
     auto& str() { return *_out; }
@@ -28,22 +146,133 @@ public:
     void operator++() { _conf_indent_f(); }
     void operator--() { _conf_indent_b(); }
 
+    /** Separators between elements, and between keys and values */
+    static constexpr u8str_view comma() { return Policy_::comma; }
+    static constexpr u8str_view colon() { return Policy_::colon; }
+
+    /** Identifies indentation state. Serialized fragments can only be reused in same format. */
+    int64_t format_key() const {
+        auto const encodings = int64_t(_binaries) << 6 | int64_t(_timestamps) << 4 | _timestamp_digits;
+        auto const layout    = int64_t(Policy_::id) << 8 | (_width() + 1);
+        return (encodings << 10 | layout) << 16 | _indent_init;
+    }
+
+    /** Whether line breaks are omitted */
+    bool is_single_line() const { return _width() < 0; }
+
+    /** Whether cached fragments of change-tracked objects can be reused. */
+    bool reuse_fragments() const { return _reuse_fragments; }
+    void reuse_fragments(bool value) { _reuse_fragments = value; }
+
+    /** Number of fraction digits of dumped timestamps, in [0, 9] */
+    int timestamp_digits() const { return _timestamp_digits; }
+    void timestamp_digits(int value) { _timestamp_digits = value; }
+
+    timestamp_encoding timestamps() const { return _timestamps; }
+    void timestamps(timestamp_encoding value) { _timestamps = value; }
+
+    binary_encoding binaries() const { return _binaries; }
+    void binaries(binary_encoding value) { _binaries = value; }
+
+    /** Stream which sidecar encoded binaries are written into; null if not given. */
+    sidecar_writer_t const* sidecar() const { return _sidecar; }
+    void sidecar(sidecar_writer_t const* writer) { _sidecar = writer; }
+
+    /** Pool which dumps ranges of at least given number of elements concurrently. */
+    thread_pool* pool() const { return _pool; }
+    size_t parallel_threshold() const { return _parallel_threshold; }
+    void parallel(thread_pool* pool, size_t min_elements) { _pool = pool, _parallel_threshold = min_elements; }
+
+    /** Creates output into other buffer, which continues from current indentation. */
+    basic_string_output fork(u8str& str) const {
+        auto r  = *this;
+        r._out  = &str;
+        r._pool = nullptr; // chunks are already dumped concurrently
+        r._sink = nullptr;
+        return r;
+    }
+
+    /**
+     * Drains buffer into sink whenever it exceeds given size, at points where no written bytes
+     *are referred anymore; i.e. between properties. Remaining bytes are drained by \ref flush.
+     */
+    void sink(std::function<void(u8str_view)> fn, size_t buffer_size) {
+        _sink = std::move(fn), _sink_threshold = buffer_size;
+    }
+
+    /** Whether buffer is drained into sink; written bytes of object may not stay in buffer then. */
+    bool has_sink() const { return bool(_sink); }
+
+    void flush_if_full() {
+        if (_sink && _out->size() >= _sink_threshold) { flush(); }
+    }
+
+    void flush() {
+        if (_sink && !_out->empty()) { _sink(*_out), _out->clear(); }
+    }
+
 private:
-    void _break_indent();
-    void _conf_indent_f() { _indent_init += _indent_width; }
-    void _conf_indent_b() { _indent_init -= _indent_width; }
+    int _width() const {
+        if constexpr (Policy_::fixed) {
+            return Policy_::width;
+        } else {
+            return _indent_width;
+        }
+    }
+
+    void _break_indent() {
+        if constexpr (Policy_::fixed) {
+            if constexpr (Policy_::width >= 0) {
+                // line break and indentation are written at once, from precomputed characters.
+                static constexpr auto fills = [] {
+                    std::array<char, 128> r = {};
+                    for (auto& ch : r) { ch = Policy_::fill; }
+                    return r[0] = '\n', r;
+                }();
+
+                size_t n = size_t(_indent_init) + 1;
+                for (auto p = fills.data(); n > 0; p = fills.data() + 1) {
+                    auto const k = std::min(n, fills.size() - (p - fills.data()));
+                    _out->append(p, k), n -= k;
+                }
+            }
+        } else {
+            if (_indent_width < 0) { return; }
+
+            *_out += '\n';
+            if (_indent_width > 0) { _out->append(_indent_init, ' '); }
+        }
+    }
+
+    void _conf_indent_f() {
+        if constexpr (!Policy_::fixed || Policy_::width > 0) { _indent_init += _width(); }
+    }
+    void _conf_indent_b() {
+        if constexpr (!Policy_::fixed || Policy_::width > 0) { _indent_init -= _width(); }
+    }
 
 private:
     u8str* _out;
     int _indent_width = -1;
     int _indent_init  = 0;
-};
 
-inline void string_output::_break_indent() {
-    if (_indent_width < 0) { return; }
+    bool _reuse_fragments = false;
+    int _timestamp_digits = 3;
+    timestamp_encoding _timestamps   = timestamp_encoding::iso8601;
+    binary_encoding _binaries        = binary_encoding::base64;
+    sidecar_writer_t const* _sidecar = nullptr;
 
-    *_out += '\n';
-    if (_indent_width > 0) { _out->append(_indent_init, ' '); }
-}
+    thread_pool* _pool         = nullptr;
+    size_t _parallel_threshold = 0;
+
+    std::function<void(u8str_view)> _sink;
+    size_t _sink_threshold = 0;
+};
+
+using string_output = basic_string_output<print_policy::runtime>;
+using minified_output = basic_string_output<print_policy::minified>;
+template <int Width_>
+using pretty_output = basic_string_output<print_policy::spaces<Width_>>;
+using tabbed_output = basic_string_output<print_policy::tabs>;
 
 } // namespace kangsw::refl::marshal
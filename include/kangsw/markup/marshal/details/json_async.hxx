@@ -0,0 +1,185 @@
+#pragma once
+#include <functional>
+#include "json_dump.hxx"
+#include "json_object_from_stream.hxx"
+#include "json_parse.hxx"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define INTERNAL_CPPMARKUP_HAS_COROUTINE 1
+#endif
+
+namespace kangsw::refl::marshal {
+
+namespace _internal {
+/**
+ * Single-shot completion which is delivered either to a callback, or to an awaiting coroutine.
+ *
+ * Continuation runs on the thread which completes the operation, i.e. inside feed() or pump()
+ *called by the reactor.
+ */
+class _async_completion {
+public:
+    bool is_done() const noexcept { return _done; }
+
+    /** Invokes fn on completion; immediately, if already complete. */
+    void on_complete(std::function<void()> fn) {
+        if (_done) {
+            fn();
+        } else {
+            _continuation = std::move(fn);
+        }
+    }
+
+protected:
+    void _complete() {
+        _done = true;
+        if (auto fn = std::exchange(_continuation, nullptr)) { fn(); } // may re-arm this
+    }
+
+    void _rearm() noexcept { _done = false, _continuation = nullptr; }
+
+#if INTERNAL_CPPMARKUP_HAS_COROUTINE
+    template <typename Self_, typename Result_>
+    struct _awaiter {
+        Self_* self;
+
+        bool await_ready() const noexcept { return self->is_done(); }
+        void await_suspend(std::coroutine_handle<> h) { self->on_complete([h] { h.resume(); }); }
+        Result_ await_resume() const { return self->result(); }
+    };
+#endif
+
+private:
+    std::function<void()> _continuation;
+    bool _done = false;
+};
+} // namespace _internal
+
+/**
+ * Parses single JSON document which arrives in arbitrary pieces, without blocking.
+ *
+ * Each fed chunk is framed incrementally by \ref json_object_from_stream, thus every byte is
+ *scanned once however the document is split; whole document is parsed once it is complete. A
+ *reactor feeds received bytes of each connection, and the completion is handed to a callback
+ *registered by \ref on_complete, or resumes the coroutine which awaits this.
+ *
+ * Location of framing error refers to the fed chunk, and that of parsing error refers to the
+ *internal buffer, which is valid until \ref reset.
+ */
+class json_async_parse : public _internal::_async_completion {
+public:
+    using result_type = std::optional<json_parse::failure_report>;
+
+public:
+    explicit json_async_parse(object& out, json_parse parse = {}) : _out(&out), _parse(std::move(parse)) {
+        _framer.emplace(_frame);
+    }
+
+    json_async_parse(json_async_parse const&) = delete;
+    json_async_parse& operator=(json_async_parse const&) = delete;
+
+public:
+    /**
+     * Consumes bytes of chunk until the document completes. Returns number of consumed bytes;
+     *rest of the chunk belongs to the next document. Consumes nothing after completion.
+     */
+    size_t feed(u8str_view chunk) {
+        if (is_done()) { return 0; }
+
+        // continuation may destroy this, thus nothing is touched after completion.
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            auto const r = (*_framer)(chunk[i]);
+            if (r == json_object_from_stream::done) {
+                _result = _parse(_frame, *_out);
+                return _complete(), i + 1;
+            } else if (r == json_object_from_stream::error) {
+                _result = json_parse::failure_report{json_parse::failure_report::error_invalid_token, chunk.substr(i, 1)};
+                return _complete(), i + 1;
+            }
+        }
+        return chunk.size();
+    }
+
+    /** Notifies end of input; incomplete document fails as waiting. */
+    void close() {
+        if (is_done()) { return; }
+        _result = json_parse::failure_report{json_parse::failure_report::waiting};
+        _complete();
+    }
+
+    /** Result of completed parsing. Empty on success. */
+    result_type const& result() const noexcept { return _result; }
+
+    /** Rearms for next document, which is parsed into given object. */
+    void reset(object& out) {
+        _out = &out, _result.reset();
+        _framer.emplace(_frame);
+        _rearm();
+    }
+
+#if INTERNAL_CPPMARKUP_HAS_COROUTINE
+    auto operator co_await() noexcept { return _awaiter<json_async_parse, result_type>{this}; }
+#endif
+
+private:
+    object* _out;
+    json_parse _parse;
+
+    u8str _frame;
+    std::optional<json_object_from_stream> _framer;
+    result_type _result;
+};
+
+/**
+ * Writes JSON document into non-blocking sink, suspending while the sink is full.
+ *
+ * Writer is called with pending bytes and returns how many of them it accepted; accepting less
+ *than offered means the sink is full, thus \ref pump returns and should be called again once
+ *the sink becomes writable. Completion is delivered as of \ref json_async_parse.
+ *
+ * Document is serialized on construction, since dumping never blocks by itself.
+ */
+class json_async_dump : public _internal::_async_completion {
+public:
+    using writer_t = std::function<size_t(u8str_view)>;
+
+public:
+    json_async_dump(object const& obj, writer_t writer, int indent = -1, json_dump dump = {})
+      : _writer(std::move(writer)) {
+        dump(obj, {_buf, indent});
+    }
+
+    json_async_dump(json_async_dump const&) = delete;
+    json_async_dump& operator=(json_async_dump const&) = delete;
+
+public:
+    /** Writes pending bytes until the sink is full. Returns true if every byte is written. */
+    bool pump() {
+        if (is_done()) { return true; }
+
+        for (;;) {
+            auto const pending = u8str_view{_buf}.substr(_written);
+            auto const n       = std::min(_writer(pending), pending.size());
+            _written += n;
+
+            if (_written == _buf.size()) { return _complete(), true; } // this may be gone from here
+            if (n < pending.size()) { return false; }
+        }
+    }
+
+    /** Bytes which are not written yet */
+    u8str_view pending() const noexcept { return u8str_view{_buf}.substr(_written); }
+    void result() const noexcept {}
+
+#if INTERNAL_CPPMARKUP_HAS_COROUTINE
+    auto operator co_await() noexcept { return _awaiter<json_async_dump, void>{this}; }
+#endif
+
+private:
+    writer_t _writer;
+    u8str _buf;
+    size_t _written = 0;
+};
+
+} // namespace kangsw::refl::marshal
@@ -0,0 +1,160 @@
+#pragma once
+#include "json_dump.hxx"
+#include "json_parse.hxx"
+#include "kangsw/markup/reflection/compare.hxx"
+
+namespace kangsw::refl::marshal {
+/**
+ * Generates JSON merge patch(RFC 7396) which transforms one object into another.
+ *
+ * Both objects must share same traits. Only changed properties are written; embedded objects
+ *and maps are diffed recursively, arrays are replaced wholesale, and removed map keys are
+ *written as null.
+ */
+class json_diff {
+public:
+    /** Returns false if two objects are identical. Writes "{}" in that case. */
+    bool operator()(object const& from, object const& to, string_output o);
+};
+
+namespace Impl {
+template <typename Ty_>
+bool _equals(Ty_ const& a, Ty_ const& b) { return _internal::_compare<true>(a, b) == 0; }
+
+/**
+ * Writes members of patch object lazily; opening brace is written on first member, thus
+ *nothing is written if there's no difference.
+ */
+class _patch_writer {
+public:
+    explicit _patch_writer(string_output& o) : _o(o) {}
+
+    /** Writes key of new member. Returns position to roll back. */
+    size_t key(u8str_view k, u8str_view suffix = {}) {
+        auto const pos = _o.str().size();
+        _rollback_empty = !_written;
+
+        if (_written) {
+            _o << ',';
+        } else {
+            _o << '{', ++_o;
+        }
+
+        _written = true;
+        _o << break_indent;
+        _o.wrap('"', k, suffix) << ": ";
+        return pos;
+    }
+
+    /** Cancels member which was written last */
+    void rollback(size_t pos) {
+        _o.str().resize(pos);
+        if (_rollback_empty) { _written = false, --_o; }
+    }
+
+    bool close() {
+        if (_written) { --_o, _o << break_indent << '}'; }
+        return _written;
+    }
+
+    string_output& out() { return _o; }
+
+private:
+    string_output& _o;
+    bool _written        = false;
+    bool _rollback_empty = false;
+};
+
+inline bool _diff(object const& a, object const& b, string_output& o);
+
+template <typename Ty_>
+bool _diff(property_proxy<u8str_map<Ty_>, true> a, property_proxy<u8str_map<Ty_>, true> b, string_output& o) {
+    _patch_writer w{o};
+
+    a.for_each([&](u8str_view key, auto const&) {
+        if (b.find(key) == nullptr) { w.key(key), o << "null"; }
+    });
+
+    b.for_each([&](u8str_view key, auto const& value) {
+        auto found = a.find(key);
+        if (found == nullptr) {
+            w.key(key), _dump(value, o);
+        } else if constexpr (std::is_same_v<Ty_, object>) {
+            auto pos = w.key(key);
+            if (!_diff(*found, value, o)) { w.rollback(pos); }
+        } else if (!_equals(*found, value)) {
+            w.key(key), _dump(value, o);
+        }
+    });
+
+    return w.close();
+}
+
+inline bool _diff(object const& a, object const& b, string_output& o) {
+    _patch_writer w{o};
+    materialize(a), materialize(b);
+
+    for (auto& prop : b.properties()) {
+        if (!prop.attributes().empty()) {
+            // "PropTag~@@ATTR@@": { "Attribute": value, ... }
+            auto const block_pos = w.key(prop.tag(), ATTR_SUFFIX);
+            _patch_writer attrs{o};
+
+            for (auto& attr : prop.attributes()) {
+                visit_property(b.base(), attr, [&](auto pb) {
+                    if (!_equals(*decltype(pb){attr, a[attr]}, *pb)) {
+                        attrs.key(attr.name), json_dump::_visitor{o}(pb);
+                    }
+                });
+            }
+
+            if (!attrs.close()) { w.rollback(block_pos); }
+        }
+
+        visit_property(b.base(), prop, [&](auto pb) {
+            using proxy_type = decltype(pb);
+            auto constexpr T = pb.type();
+            auto const pa    = proxy_type{prop, a[prop]};
+
+            if constexpr (T.is_object() && !T.is_container()) {
+                auto pos = w.key(prop.tag());
+                if (!_diff(*pa, *pb, o)) { w.rollback(pos); }
+            } else if constexpr (T.is_map()) {
+                auto pos = w.key(prop.tag());
+                if (!_diff(pa, pb, o)) { w.rollback(pos); }
+            } else if (!_equals(pa, pb)) {
+                // scalars and arrays are replaced as a whole.
+                w.key(prop.tag()), json_dump::_visitor{o}(pb);
+            }
+        });
+    }
+
+    return w.close();
+}
+} // namespace Impl
+
+inline bool json_diff::operator()(object const& from, object const& to, string_output o) {
+    if (&from.traits() != &to.traits()) {
+        throw std::invalid_argument{"Objects of different type can't be compared."};
+    }
+
+    if (!Impl::_diff(from, to, o)) {
+        o << "{}";
+        return false;
+    }
+
+    o << break_indent;
+    return true;
+}
+
+/** Generates merge patch which transforms 'from' into 'to'. */
+inline bool diff(object const& from, object const& to, string_output o) {
+    return json_diff{}(from, to, o);
+}
+
+/** Applies JSON merge patch, which may be generated by \ref diff(), onto object. */
+inline auto apply_patch(u8str_view patch, object& out) {
+    return json_parse{true}(patch, out);
+}
+
+} // namespace kangsw::refl::marshal
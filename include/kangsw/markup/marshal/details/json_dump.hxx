@@ -2,37 +2,144 @@
 #include "strutils.hxx"
 #include "generics.hxx"
 #include "trivial_marshal.hxx"
+#include "kangsw/markup/reflection/hash.hxx"
 #include "kangsw/markup/reflection/property_proxy.hxx"
+#include "kangsw/markup/utility/base85.hxx"
+#include "kangsw/markup/utility/hex.hxx"
+#include "kangsw/markup/utility/thread_pool.hxx"
 
 namespace kangsw::refl::marshal {
-/** Dump given object as json */
+/**
+ * Dump given object as json
+ *
+ * If fragment reuse is enabled, unmodified properties of change-tracked objects are copied from
+ *their cached serialized bytes instead of being encoded again. Change-tracked object of which
+ *subtree is unmodified as a whole is copied at once.
+ *
+ * Same object may be dumped concurrently, as cached fragments are guarded by its state; unless
+ *it has deferred values, which are parsed on dump.
+ */
 class json_dump {
 public:
-    void operator()(object const& obj, string_output o);
+    json_dump(bool reuse_fragments = false) noexcept : _reuse_fragments(reuse_fragments) {}
 
+    /**
+     * Dumps arrays and maps of at least min_elements elements concurrently on given pool. They are
+     *split into chunks, each of which is dumped into its own buffer, then stitched in order; output
+     *is identical to serial one. Pool must outlive this dumper.
+     */
+    json_dump& parallel(thread_pool& pool, size_t min_elements = 1024) noexcept {
+        _pool = &pool, _parallel_threshold = min_elements;
+        return *this;
+    }
+
+    /** Number of fraction digits of timestamps; 3, 6 and 9 give milli, micro and nanoseconds. */
+    json_dump& timestamp_digits(int fraction_digits) noexcept {
+        _timestamp_digits = std::clamp(fraction_digits, 0, 9);
+        return *this;
+    }
+
+    /** Encodes timestamps as given, unless overridden by property flags. */
+    json_dump& timestamps(timestamp_encoding encoding) noexcept {
+        _timestamps = encoding;
+        return *this;
+    }
+
+    /** Encodes binaries as given, unless overridden by property flags. */
+    json_dump& binaries(binary_encoding encoding) noexcept {
+        _binaries = encoding;
+        return *this;
+    }
+
+    /**
+     * Writes blobs of sidecar encoded binaries through given writer, in order of the document;
+     *document refers them by offset and length instead. Dumping is never parallel with sidecar.
+     */
+    json_dump& sidecar(sidecar_writer_t writer) {
+        _sidecar = std::move(writer);
+        return *this;
+    }
+
+    void operator()(object const& obj, string_output o) { _dump_root(obj, o); }
+
+    /** Dumps in layout of given print policy, which is fixed at compile time. */
+    template <typename Policy_>
+    void operator()(object const& obj, basic_string_output<Policy_> o) { _dump_root(obj, o); }
+
+    template <typename Policy_>
     struct _visitor {
+        _visitor(basic_string_output<Policy_>& o) : o(o) {}
         template <typename Ty_> void operator()(property_proxy<Ty_, true> p);
-        string_output& o;
+        basic_string_output<Policy_>& o;
     };
+
+private:
+    template <typename Policy_>
+    void _dump_root(object const& obj, basic_string_output<Policy_>& o);
+
+private:
+    bool _reuse_fragments;
+    int _timestamp_digits = 3;
+    timestamp_encoding _timestamps = timestamp_encoding::iso8601;
+    binary_encoding _binaries      = binary_encoding::base64;
+    sidecar_writer_t _sidecar;
+
+    thread_pool* _pool         = nullptr;
+    size_t _parallel_threshold = 0;
 };
 
 namespace Impl {
-template <typename Ty_>
-void _dump(Ty_ const& v, string_output& o) {
+template <typename Policy_>
+void _dump_sidecar(binary_chunk const& v, basic_string_output<Policy_>& o) {
+    if (o.sidecar() == nullptr) { throw std::logic_error{"sidecar encoded binary requires sidecar writer"}; }
+    uint64_t const offset = v.empty() ? 0 : (*o.sidecar())(v.data(), v.size());
+
+    char buf[48];
+    auto end = std::to_chars(buf, buf + sizeof buf, offset).ptr;
+    *end++   = ':';
+    end      = std::to_chars(end, buf + sizeof buf, v.size()).ptr;
+    o << '"' << u8str_view(buf, size_t(end - buf)) << '"';
+}
+
+template <typename Ty_, typename Policy_>
+void _dump(Ty_ const& v, basic_string_output<Policy_>& o) {
     auto constexpr T = etype::from_type<Ty_>();
     using E          = etype::_type;
 
     if constexpr (T.is_one_of(E::floating_point, E::integer, E::boolean, E::null)) {
         generic_stringfy<Ty_>{}(v, std::back_inserter(o.str()));
-    } else if constexpr (T.is_one_of(etype::timestamp, etype::binary)) {
-        o << '"';
-        generic_stringfy<Ty_>{}(v, std::back_inserter(o.str()));
-        o << '"';
+    } else if constexpr (T.is_timestamp()) {
+        if (o.timestamps() != timestamp_encoding::iso8601) {
+            generic_stringfy<int64_t>{}(to_epoch(v, o.timestamps()), std::back_inserter(o.str()));
+            return;
+        }
+
+        char buf[timestamp::max_formatted_size];
+        auto const end = timestamp::format(buf, v, o.timestamp_digits());
+        o << '"' << u8str_view(buf, size_t(end - buf)) << '"';
+    } else if constexpr (T.is_binary()) {
+        auto const encoding = o.binaries();
+        if (encoding == binary_encoding::sidecar) { return _dump_sidecar(v, o); }
+
+        // encoded in place, as size of the output is known in advance.
+        auto const size = encoding == binary_encoding::hex      ? hex::encoded_size(v.size())
+                          : encoding == binary_encoding::base85 ? base85::encoded_size(v.size())
+                                                                : base64::encoded_size(v.size());
+        auto& str         = o.str();
+        auto const offset = str.size() + 1;
+        str.resize(offset + size + 1);
+        str[offset - 1] = '"', str.back() = '"';
+
+        switch (encoding) {
+            case binary_encoding::hex: hex::encode_to(v.data(), v.size(), str.data() + offset); break;
+            case binary_encoding::base85: base85::encode_to(v.data(), v.size(), str.data() + offset); break;
+            default: base64::encode_to(v.data(), v.size(), str.data() + offset); break;
+        }
     } else if constexpr (T.is_string()) {
         o << '"';
         for (char ch : v) {
             // Handle escape
-            if (iscntrl(ch)) {
+            if (ch == '"' || ch == '\\' || iscntrl(ch)) {
                 switch (ch) {
                     case '"': o << "\\\""; break;
                     case '\\': o << "\\\\"; break;
@@ -61,24 +168,114 @@ void _dump(Ty_ const& v, string_output& o) {
     }
 }
 
-template <>
-inline void _dump<object>(object const& v, string_output& o) {
-    o << '{', ++o; // Write value first -> indent later
+/** Tests if raw JSON value has no whitespace between its tokens. */
+inline bool _is_compact(u8str_view raw) {
+    bool in_string = false;
+    for (size_t i = 0; i < raw.size(); ++i) {
+        auto const ch = raw[i];
+        if (in_string) {
+            if (ch == '\\') {
+                ++i;
+            } else if (ch == '"') {
+                in_string = false;
+            }
+        } else if (ch == '"') {
+            in_string = true;
+        } else if (ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Whether deferred raw value can be forwarded as is; it must be written in encodings of output,
+ *and binaries in it must reach the sidecar if there's one. Single-line output takes no line
+ *breaks, and minified one takes no whitespace at all.
+ */
+template <typename Policy_>
+bool _can_forward(u8str_view raw, int64_t encoding, basic_string_output<Policy_> const& o) {
+    if (o.sidecar() || encoding != encoding_key(o.timestamps(), o.binaries())) { return false; }
+    if (!o.is_single_line()) { return true; }
+    return o.comma().size() == 1 ? _is_compact(raw) : raw.find_first_of("\r\n") == raw.npos;
+}
+
+/**
+ * Hashes versions of object and every object it contains into h, which then changes whenever any
+ *of them is modified. Returns false if any of them is not change-tracked.
+ */
+inline bool _signature(object const& v, hasher& h) {
+    auto const state = v.state();
+    if (state == nullptr) { return false; }
+    h.update_value(state->version());
+
+    // adding or removing elements modifies owner itself, thus only versions of elements are hashed.
+    for (auto& prop : v.properties()) {
+        if (!prop.type().is_object()) { continue; }
+
+        auto const mem = prop.memory()(v.base());
+        if (prop.type().is_array()) {
+            for (size_t i = 0, n = prop.ovi()->size(mem); i < n; ++i) {
+                if (!_signature(prop.ovi()->at(mem, i), h)) { return false; }
+            }
+        } else if (prop.type().is_map()) {
+            bool valid = true;
+            prop.omi()->for_each(mem, [&](u8str_view, object const& elem) { valid = valid && _signature(elem, h); });
+            if (!valid) { return false; }
+        } else if (!_signature(*static_cast<object const*>(mem), h)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Policy_>
+void _dump(object const& v, basic_string_output<Policy_>& o) {
     auto const baseaddr = v.base();
+    auto const state    = o.reuse_fragments() ? v.state() : nullptr;
+    auto const format   = o.format_key();
+    auto const deferred = v.state() && v.state()->any_deferred() ? v.state() : nullptr;
 
+    // whole object is reused while none of objects in it is modified; it's never stored if bytes
+    //may be drained in the middle, nor if it refers sidecar offsets, which differ by stream.
+    uint64_t signature = 0;
+    bool whole         = false;
+    if (state && !o.sidecar() && !o.has_sink()) {
+        hasher h;
+        whole = _signature(v, h), signature = h.digest();
+    }
+
+    if (whole && state->append_fragment(object_state::whole, format, signature, o.str())) { return; }
+    auto const object_begin = o.str().size();
+
+    o << '{', ++o; // Write value first -> indent later
     for (auto& prop : v.properties()) {
+        o.flush_if_full();
+
+        // properties which contain objects are cached as whole fragments of those objects; sidecar
+        //binaries are never cached, as their offsets differ by stream.
+        size_t const prop_idx     = &prop - v.properties().data();
+        bool const is_sidecar     = prop.type().is_binary() && binary_encoding_of(prop, o.binaries()) == binary_encoding::sidecar;
+        bool const cacheable      = state && !prop.type().is_object() && !is_sidecar;
+        auto const fragment_begin = o.str().size();
+
+        if (cacheable && state->append_fragment(prop_idx, format, 0, o.str())) {
+            if (prop_idx + 1 < v.properties().size()) { o << ','; }
+            continue;
+        }
+
         o << break_indent;
 
         if (!prop.attributes().empty()) {
             // "PropTag~@@ATTR@@": {
-            o.wrap('"', prop.tag(), ATTR_SUFFIX) << ": {";
+            o.wrap('"', prop.tag(), ATTR_SUFFIX) << o.colon() << '{';
             ++o;
 
             for (auto& attr : prop.attributes()) {
                 o << break_indent;
 
                 // "Attribute tag": value
-                o.wrap('"', attr.name) << ": ";
+                o.wrap('"', attr.name) << o.colon();
                 visit_property(baseaddr, attr, json_dump::_visitor{o});
 
                 size_t attr_idx = &attr - prop.attributes().data();
@@ -89,52 +286,139 @@ inline void _dump<object>(object const& v, string_output& o) {
             o << break_indent << "}," << break_indent;
         }
 
-        o.wrap('"', prop.tag()) << ": ";
-        visit_property(baseaddr, prop, json_dump::_visitor{o});
+        o.wrap('"', prop.tag()) << o.colon();
+        // values which were never accessed are forwarded as they were received, unless they can't
+        //be; those are parsed, then dumped in place.
+        auto raw = deferred ? deferred->deferred(prop_idx) : nullptr;
+        if (raw && !_can_forward(*raw, deferred->deferred_encoding(prop_idx), o)) { raw = nullptr; }
+
+        if (raw) {
+            o << *raw;
+        } else if (prop.flags() != property_flag::none) {
+            auto const timestamps = o.timestamps();
+            auto const binaries   = o.binaries();
+            o.timestamps(timestamp_encoding_of(prop, timestamps)), o.binaries(binary_encoding_of(prop, binaries));
+            visit_property(baseaddr, prop, json_dump::_visitor{o});
+            o.timestamps(timestamps), o.binaries(binaries);
+        } else {
+            visit_property(baseaddr, prop, json_dump::_visitor{o});
+        }
+
+        if (cacheable && !raw) {
+            state->store_fragment(prop_idx, format, u8str_view{o.str()}.substr(fragment_begin));
+        }
 
-        size_t prop_idx = &prop - v.properties().data();
         if (prop_idx + 1 < v.properties().size()) { o << ','; }
     }
 
     --o, o << break_indent << '}';
+    if (whole) { state->store_fragment(object_state::whole, format, u8str_view{o.str()}.substr(object_begin), signature); }
 }
 
-template <typename Ty_>
-void _dump(property_proxy<std::vector<Ty_>, true> v, string_output& o) {
+template <typename Policy_>
+bool _is_parallel(basic_string_output<Policy_> const& o, size_t num_elems) {
+    // sidecar blobs must be written in order of the document.
+    return o.sidecar() == nullptr && o.pool() && o.pool()->size() > 0 && num_elems >= o.parallel_threshold();
+}
+
+/** Writes n comma separated elements, each of which is written by dump_elem(index, output). */
+template <typename Policy_, typename ElemFn_>
+void _dump_elements(size_t n, basic_string_output<Policy_>& o, ElemFn_&& dump_elem) {
+    auto const write = [&](basic_string_output<Policy_>& out, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            out << break_indent;
+            dump_elem(i, out);
+
+            if (i + 1 < n) { out << out.comma(); }
+        }
+    };
+
+    if (!_is_parallel(o, n)) { return write(o, 0, n); }
+
+    // a few chunks per thread, to balance elements of uneven size.
+    auto const num_chunks = std::min(n, (o.pool()->size() + 1) * 4);
+    std::vector<u8str> chunks(num_chunks);
+    o.pool()->parallel_for(num_chunks, [&](size_t c) {
+        auto out = o.fork(chunks[c]);
+        write(out, n * c / num_chunks, n * (c + 1) / num_chunks);
+    });
+
+    for (auto& chunk : chunks) { o << chunk; }
+}
+
+template <typename Proxy_, typename Policy_>
+void _dump_array(Proxy_ const& v, basic_string_output<Policy_>& o) {
     o << '[', ++o;
 
-    for (size_t i = 0, end = v.size(); i < end; ++i) {
-        o << break_indent;
-        auto& elem = v[i];
-        _dump(elem, o);
+    _dump_elements(v.size(), o, [&v](size_t i, basic_string_output<Policy_>& out) {
+        decltype(auto) elem = v[i];
+        _dump(elem, out);
+    });
 
-        if (i + 1 < end) { o << ", "; }
-    }
+    --o, o << break_indent << ']';
+}
 
+template <typename Ty_, typename Policy_>
+void _dump(property_proxy<std::vector<Ty_>, true> v, basic_string_output<Policy_>& o) {
+    _dump_array(v, o);
+}
+
+template <typename Policy_>
+void _dump(property_proxy<bit_vector, true> v, basic_string_output<Policy_>& o) {
+    _dump_array(v, o);
+}
+
+template <typename Ty_, typename Policy_>
+void _dump(property_proxy<fixed_array_t<Ty_>, true> v, basic_string_output<Policy_>& o) {
+    _dump_array(v, o);
+}
+
+template <typename Ty_, typename Policy_>
+void _dump(property_proxy<small_vector_base<Ty_>, true> v, basic_string_output<Policy_>& o) {
+    _dump_array(v, o);
+}
+
+template <typename Ty_, typename Policy_>
+void _dump(property_proxy<nested_vector<Ty_>, true> v, basic_string_output<Policy_>& o) {
+    o << '[', ++o;
+    _dump_elements(v.size(), o, [&v](size_t i, basic_string_output<Policy_>& out) { _dump_array(v[i], out); });
     --o, o << break_indent << ']';
 }
 
-template <typename Ty_>
-void _dump(property_proxy<u8str_map<Ty_>, true> v, string_output& o) {
+template <typename Ty_, typename Policy_>
+void _dump(property_proxy<u8str_map<Ty_>, true> v, basic_string_output<Policy_>& o) {
     o << '{', ++o;
     size_t counter = 0;
     size_t size    = v.size();
 
-    v.for_each([&o, &counter, size](u8str_view s, Ty_ const& v_i) {
-        o << break_indent;
-        o.wrap('"', s) << ": ";
-        _dump(v_i, o);
+    if (_is_parallel(o, size)) {
+        // entries are gathered first, as maps can only be iterated.
+        std::vector<std::pair<u8str_view, Ty_ const*>> entries;
+        entries.reserve(size);
+        v.for_each([&entries](u8str_view s, Ty_ const& v_i) { entries.emplace_back(s, &v_i); });
 
-        if (++counter < size) { o << ", "; }
-    });
+        _dump_elements(size, o, [&entries](size_t i, basic_string_output<Policy_>& out) {
+            out.wrap('"', entries[i].first) << out.colon();
+            _dump(*entries[i].second, out);
+        });
+    } else {
+        v.for_each([&o, &counter, size](u8str_view s, Ty_ const& v_i) {
+            o << break_indent;
+            o.wrap('"', s) << o.colon();
+            _dump(v_i, o);
+
+            if (++counter < size) { o << o.comma(); }
+        });
+    }
 
     --o, o << break_indent << '}';
 }
 
 } // namespace Impl
 
+template <typename Policy_>
 template <typename Ty_>
-void json_dump::_visitor::operator()(property_proxy<Ty_, true> p) {
+void json_dump::_visitor<Policy_>::operator()(property_proxy<Ty_, true> p) {
     auto constexpr T = etype::from_type<Ty_>();
     if constexpr (!T.is_container()) {
         Impl::_dump(*p, o);
@@ -143,9 +427,17 @@ void json_dump::_visitor::operator()(property_proxy<Ty_, true> p) {
     }
 }
 
-inline void json_dump::operator()(object const& obj, string_output o) {
+template <typename Policy_>
+void json_dump::_dump_root(object const& obj, basic_string_output<Policy_>& o) {
+    o.reuse_fragments(_reuse_fragments);
+    o.timestamp_digits(_timestamp_digits);
+    o.timestamps(_timestamps);
+    o.binaries(_binaries);
+    o.sidecar(_sidecar ? &_sidecar : nullptr);
+    o.parallel(_pool, _parallel_threshold);
     Impl::_dump(obj, o);
     o << break_indent;
+    o.flush();
 }
 
 } // namespace kangsw::refl::marshal
\ No newline at end of file
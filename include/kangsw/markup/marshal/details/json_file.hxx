@@ -0,0 +1,200 @@
+#pragma once
+#include <cstdio>
+#include <istream>
+#include <system_error>
+#include "json_dump.hxx"
+#include "json_parse.hxx"
+#include "kangsw/markup/utility/mapped_file.hxx"
+
+#if _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace kangsw::refl::marshal {
+
+struct json_file_options {
+    int indent          = -1;
+    size_t staging_size = 1 << 20; // bytes which are buffered before each write
+    bool sync           = false;   // flushes to storage device before returning
+};
+
+namespace _internal {
+/** Document is released after parsing, thus location of failure can't be retained. */
+inline std::optional<json_parse::failure_report> _detach(std::optional<json_parse::failure_report> report) {
+    if (report) { report->where = {}; }
+    return report;
+}
+
+class _file_writer {
+public:
+    explicit _file_writer(std::filesystem::path const& path) {
+#if _WIN32
+        _fd = ::_wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        _fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+        if (_fd < 0) { _throw_errno("open"); }
+    }
+
+    ~_file_writer() {
+        if (_fd >= 0) { _close(_fd); }
+    }
+
+    void write(u8str_view s) {
+        while (!s.empty()) {
+#if _WIN32
+            auto n = ::_write(_fd, s.data(), unsigned(std::min<size_t>(s.size(), INT_MAX)));
+#else
+            auto n = ::write(_fd, s.data(), s.size());
+            if (n < 0 && errno == EINTR) { continue; }
+#endif
+            if (n < 0) { _throw_errno("write"); }
+            s.remove_prefix(size_t(n));
+        }
+    }
+
+    void sync() {
+#if _WIN32
+        if (::_commit(_fd) != 0) { _throw_errno("commit"); }
+#else
+        if (::fsync(_fd) != 0) { _throw_errno("fsync"); }
+#endif
+    }
+
+    void close() {
+        if (_close(std::exchange(_fd, -1)) != 0) { _throw_errno("close"); }
+    }
+
+private:
+    static int _close(int fd) {
+#if _WIN32
+        return ::_close(fd);
+#else
+        return ::close(fd);
+#endif
+    }
+
+    [[noreturn]] static void _throw_errno(char const* what) {
+        throw std::system_error{errno, std::generic_category(), what};
+    }
+
+private:
+    int _fd = -1;
+};
+} // namespace _internal
+
+/**
+ * Parses json file, which is mapped into memory instead of being copied into heap.
+ *
+ * Throws std::system_error if file can't be read. Failure of waiting code means the document
+ *is truncated. Location of failure is not reported.
+ */
+inline std::optional<json_parse::failure_report> load_json_file(
+  std::filesystem::path const& path, object& out, json_parse parse = {}) {
+    mapped_file file{path};
+    return _internal::_detach(parse(file.view(), out));
+}
+
+/**
+ * Parses json document from stream which can't be mapped; i.e. pipes or sockets. Stream is
+ *read by chunks into single buffer, which is pre-sized if the stream is seekable.
+ */
+inline std::optional<json_parse::failure_report> load_json(
+  std::istream& in, object& out, json_parse parse = {}, size_t chunk_size = 64 << 10) {
+    u8str buf;
+    if (auto const begin = in.tellg(); begin != std::istream::pos_type(-1)) {
+        in.seekg(0, std::ios::end);
+        if (auto const end = in.tellg(); end > begin) { buf.reserve(size_t(end - begin)); }
+        in.seekg(begin);
+    }
+
+    while (in) {
+        auto const n = buf.size();
+        buf.resize(n + chunk_size);
+        in.read(buf.data() + n, std::streamsize(chunk_size));
+        buf.resize(n + size_t(in.gcount()));
+    }
+
+    if (in.bad()) { throw std::system_error{std::make_error_code(std::io_errc::stream), "read"}; }
+    return _internal::_detach(parse(buf, out));
+}
+
+inline std::optional<json_parse::failure_report> load_json(
+  FILE* in, object& out, json_parse parse = {}, size_t chunk_size = 64 << 10) {
+    u8str buf;
+    for (size_t read = chunk_size; read == chunk_size;) {
+        auto const n = buf.size();
+        buf.resize(n + chunk_size);
+        read = fread(buf.data() + n, 1, chunk_size, in);
+        buf.resize(n + read);
+    }
+
+    if (ferror(in)) { throw std::system_error{errno, std::generic_category(), "fread"}; }
+    return _internal::_detach(parse(buf, out));
+}
+
+/**
+ * Dumps object into file through staging buffer of bounded size, thus whole document is never
+ *held in memory. Throws std::system_error on I/O failure.
+ */
+inline void save_json_file(
+  std::filesystem::path const& path, object const& obj, json_file_options const& opts = {}, json_dump dump = {}) {
+    _internal::_file_writer file{path};
+
+    u8str staging;
+    staging.reserve(opts.staging_size);
+
+    string_output o{staging, opts.indent};
+    o.sink([&file](u8str_view s) { file.write(s); }, opts.staging_size);
+    dump(obj, o);
+
+    if (opts.sync) { file.sync(); }
+    file.close();
+}
+
+/**
+ * Sidecar file which blobs of sidecar encoded binaries are appended into, to be given to
+ *\ref json_dump::sidecar. Blobs are written as they are, without staging. Copies share the file.
+ */
+class sidecar_file_writer {
+public:
+    explicit sidecar_file_writer(std::filesystem::path const& path)
+      : _file(std::make_shared<_internal::_file_writer>(path)), _size(std::make_shared<uint64_t>(0)) {}
+
+    uint64_t operator()(void const* data, size_t size) {
+        _file->write(u8str_view{static_cast<char const*>(data), size});
+        return std::exchange(*_size, *_size + size);
+    }
+
+    /** Closes the file, after flushing it to storage device if requested. */
+    void close(bool sync = false) {
+        if (sync) { _file->sync(); }
+        _file->close();
+    }
+
+private:
+    std::shared_ptr<_internal::_file_writer> _file;
+    std::shared_ptr<uint64_t> _size;
+};
+
+/** Sidecar file which is mapped into memory, to be given to \ref json_parse::sidecar. */
+class sidecar_file_reader {
+public:
+    explicit sidecar_file_reader(std::filesystem::path const& path) : _file(std::make_shared<mapped_file>(path)) {}
+
+    bool operator()(uint64_t offset, size_t size, void* out) const {
+        auto const blobs = _file->view();
+        if (offset > blobs.size() || size > blobs.size() - offset) { return false; }
+        return memcpy(out, blobs.data() + offset, size), true;
+    }
+
+private:
+    std::shared_ptr<mapped_file> _file;
+};
+
+} // namespace kangsw::refl::marshal
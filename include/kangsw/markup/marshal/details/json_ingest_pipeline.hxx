@@ -0,0 +1,241 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include "json_object_from_stream.hxx"
+#include "json_parse.hxx"
+#include "kangsw/markup/reflection/type_registry.hxx"
+#include "kangsw/markup/utility/thread_pool.hxx"
+
+namespace kangsw::refl::marshal {
+
+enum class json_framing {
+    ndjson,       // an object per line
+    concatenated, // objects are delimited by balanced braces
+};
+
+struct json_ingest_options {
+    json_framing framing  = json_framing::ndjson;
+    size_t num_workers    = std::thread::hardware_concurrency();
+    size_t queue_capacity = 256; // maximum number of frames in flight
+};
+
+/**
+ * Parses continuous stream of JSON objects on worker threads.
+ *
+ * Calling thread frames objects from fed chunks, either by newline(NDJSON) or by balancing
+ *braces through \ref json_object_from_stream. Each frame is parsed into pooled object of target
+ *type by a worker, then delivered to the consumer in order of the stream; consumer is invoked
+ *by one worker at a time.
+ *
+ * Number of frames in flight is bounded by queue capacity; feeding blocks while it is full.
+ *Frames which fail to be framed or parsed, including truncated ones, are counted, then dropped.
+ */
+class json_ingest_pipeline {
+public:
+    using framing_type = json_framing;
+    using options      = json_ingest_options;
+    using consumer_t   = std::function<void(pooled_object)>;
+
+public:
+    json_ingest_pipeline(object_traits const& traits, consumer_t consumer, options opts = {})
+      : _traits(traits),
+        _consumer(std::move(consumer)),
+        _framing(opts.framing),
+        _slots(std::max<size_t>(1, opts.queue_capacity)),
+        _pool(std::max<size_t>(1, opts.num_workers)) {
+        _reset_framer();
+    }
+
+    /** Binds to type of given name in global \ref type_registry. */
+    json_ingest_pipeline(u8str_view type_name, consumer_t consumer, options opts = {})
+      : json_ingest_pipeline(_find_traits(type_name), std::move(consumer), opts) {}
+
+    json_ingest_pipeline(json_ingest_pipeline const&) = delete;
+    json_ingest_pipeline& operator=(json_ingest_pipeline const&) = delete;
+
+    ~json_ingest_pipeline() {
+        try {
+            finish();
+        } catch (...) {
+            // errors of consumer are only reported through finish().
+        }
+    }
+
+public:
+    /** Frames objects of given chunk, then queues them. Rethrows exception of consumer, if any. */
+    void feed(u8str_view chunk) {
+        if (_framing == framing_type::ndjson) {
+            for (size_t pos = 0; pos < chunk.size();) {
+                auto const newline = chunk.find('\n', pos);
+                if (newline == chunk.npos) {
+                    _partial.append(chunk.substr(pos));
+                    break;
+                }
+
+                if (_partial.empty()) {
+                    _submit(chunk.substr(pos, newline - pos));
+                } else {
+                    _partial.append(chunk.substr(pos, newline - pos));
+                    _submit(_partial), _partial.clear();
+                }
+                pos = newline + 1;
+            }
+        } else {
+            for (char ch : chunk) {
+                auto const result = (*_framer)(ch);
+                if (result == json_object_from_stream::done) {
+                    _submit(_partial), _reset_framer();
+                } else if (result == json_object_from_stream::error) {
+                    // bytes are skipped until next object begins, which counts as single failure.
+                    if (!_is_skipping) { _count_failure(); }
+                    _is_skipping = true, _reset_framer();
+                } else if (!_partial.empty()) {
+                    _is_skipping = false;
+                }
+            }
+        }
+
+        _rethrow_if_failed();
+    }
+
+    /** Submits trailing frame, then blocks until every queued frame is delivered. */
+    void finish() {
+        if (_framing == framing_type::ndjson && !_partial.empty()) { _submit(_partial), _partial.clear(); }
+
+        std::unique_lock l{_lock};
+        _wait(l, [this] { return _num_delivered == _num_submitted; });
+        l.unlock();
+
+        _rethrow_if_failed();
+    }
+
+    /** Number of frames which were dropped due to malformed input */
+    size_t num_failed() const {
+        std::lock_guard _{_lock};
+        return _num_failed;
+    }
+
+    object_traits const& traits() const { return _traits; }
+
+private:
+    struct _slot {
+        u8str frame;
+        json_parse parser;
+        pooled_object object;
+        bool is_ready = false;
+    };
+
+    static object_traits const& _find_traits(u8str_view type_name) {
+        auto traits = type_registry::global().find_traits(type_name);
+        if (traits == nullptr) { throw std::invalid_argument{"unknown type: " + u8str(type_name)}; }
+        return *traits;
+    }
+
+    void _reset_framer() {
+        _framer.emplace(_partial); // clears buffer
+    }
+
+    void _submit(u8str_view frame) {
+        if (frame.find_first_not_of(" \t\r\n") == frame.npos) { return; }
+
+        std::unique_lock l{_lock};
+        _wait(l, [this] { return _num_submitted - _num_delivered < _slots.size(); });
+
+        auto const seq = _num_submitted++;
+        auto& slot     = _slots[seq % _slots.size()];
+        l.unlock();
+
+        // slot is exclusively owned until it is marked ready.
+        slot.frame.assign(frame.begin(), frame.end());
+        _pool.post([this, seq] { _parse(seq); });
+    }
+
+    void _parse(size_t seq) {
+        auto& slot = _slots[seq % _slots.size()];
+
+        // parser keeps partial input of truncated frame, which must not leak into the next frame of
+        //this slot; thus it is replaced on any failure, including waiting for more input.
+        pooled_object object;
+        try {
+            object = _traits.acquire_object();
+            if (slot.parser(slot.frame, *object).has_value()) { object.reset(); }
+        } catch (...) {
+            object.reset();
+        }
+        if (!object) { slot.parser = json_parse{}; }
+
+        std::unique_lock l{_lock};
+        slot.object = std::move(object), slot.is_ready = true;
+        if (_is_delivering) { return; } // current deliverer will pick it up
+
+        // delivers every consecutive ready frame from the oldest one.
+        _is_delivering = true;
+        for (;;) {
+            auto& next = _slots[_num_delivered % _slots.size()];
+            if (_num_delivered == _num_submitted || !next.is_ready) { break; }
+
+            auto delivered   = std::move(next.object);
+            bool const is_ok = delivered && !_error; // after consumer failed, nothing is delivered
+            next.is_ready    = false;
+            if (!delivered) { ++_num_failed; }
+            l.unlock();
+
+            std::exception_ptr error;
+            if (is_ok) {
+                try {
+                    _consumer(std::move(delivered));
+                } catch (...) {
+                    error = std::current_exception();
+                }
+            }
+
+            l.lock();
+            if (error && !_error) { _error = error; }
+            ++_num_delivered;
+            if (_num_waiters) { _cv.notify_all(); }
+        }
+        _is_delivering = false;
+    }
+
+    /** Waits on the lock, while delivering threads know there's a waiter to be notified. */
+    template <typename Pred_>
+    void _wait(std::unique_lock<std::mutex>& l, Pred_&& pred) {
+        ++_num_waiters;
+        _cv.wait(l, std::forward<Pred_>(pred));
+        --_num_waiters;
+    }
+
+    void _count_failure() {
+        std::lock_guard _{_lock};
+        ++_num_failed;
+    }
+
+    void _rethrow_if_failed() {
+        std::lock_guard _{_lock};
+        if (_error) { std::rethrow_exception(std::exchange(_error, nullptr)); }
+    }
+
+private:
+    object_traits const& _traits;
+    consumer_t _consumer;
+    framing_type _framing;
+
+    u8str _partial;
+    std::optional<json_object_from_stream> _framer;
+    bool _is_skipping = false;
+
+    mutable std::mutex _lock;
+    std::condition_variable _cv;
+    std::vector<_slot> _slots;
+    size_t _num_submitted = 0;
+    size_t _num_delivered = 0;
+    size_t _num_failed    = 0;
+    size_t _num_waiters   = 0;
+    bool _is_delivering   = false;
+    std::exception_ptr _error;
+
+    thread_pool _pool; // joined first on destruction
+};
+
+} // namespace kangsw::refl::marshal
@@ -172,7 +172,7 @@ inline json_object_from_stream::result_t json_object_from_stream::operator()(cha
                   replace(_nextc::comma_or_closing_bracket),
                   push(_nextc::string_closing_quote);
                 return ready;
-            } else if (one_of("tfn", ch) || digit(ch)) {
+            } else if (one_of("tfn-", ch) || digit(ch)) {
                 apnd(ch),
                   replace(_nextc::comma_or_closing_bracket),
                   push(_nextc::value_end);
@@ -192,14 +192,14 @@ inline json_object_from_stream::result_t json_object_from_stream::operator()(cha
                 return apnd(ch), replace(_nextc::closing_bracket), ready;
             } else if (ch == '"') {
                 return apnd(ch), replace(_nextc::string_closing_quote), ready;
-            } else if (one_of("tfn", ch) || digit(ch)) {
+            } else if (one_of("tfn-", ch) || digit(ch)) {
                 return apnd(ch), replace(_nextc::value_end), ready;
             } else {
                 return error;
             }
 
         case _nextc::value_end:
-            if (ch == '.' || alphanumeric(ch)) {
+            if (one_of(".+-", ch) || alphanumeric(ch)) {
                 return apnd(ch), ready;
             } else if (ch == '/') {
                 return push(_nextc::begin_comment_next), ready;
@@ -1,13 +1,86 @@
 #pragma once
 #include "strutils.hxx"
 #include "generics.hxx"
+#include "kangsw/markup/reflection/property_path.hxx"
 #include "kangsw/markup/reflection/property_proxy.hxx"
 #include "kangsw/markup/marshal/details/jsmn.h"
+#include "kangsw/markup/utility/base85.hxx"
+#include "kangsw/markup/utility/hex.hxx"
+#include "kangsw/markup/utility/thread_pool.hxx"
 
 namespace kangsw::refl::marshal {
 
 /**
- * 
+ * Set of properties to be materialized by \ref json_parse, compiled against object traits.
+ *
+ * Each path is JSON pointer which consists of property tags, i.e. "/embed/value"; intermediate
+ *tokens must designate embedded objects. Selected property is parsed as a whole including its
+ *attributes, and every other property is skipped without conversion.
+ */
+class json_projection {
+    friend class json_parse;
+
+    struct _node {
+        bit_vector whole;
+        std::vector<std::unique_ptr<_node>> children;
+
+        explicit _node(object_traits const& t) : whole(t.props().size()), children(t.props().size()) {}
+
+        bool selects(size_t index) const { return whole[index] || children[index]; }
+
+        /** Returns nullptr if every child property is selected. */
+        _node const* child(size_t index) const { return whole[index] ? nullptr : children[index].get(); }
+    };
+
+public:
+    json_projection(object_traits const& traits, std::initializer_list<u8str_view> paths)
+      : json_projection(traits, paths.begin(), paths.end()) {}
+
+    template <typename It_>
+    json_projection(object_traits const& traits, It_ first, It_ last) : _traits(&traits), _root(traits) {
+        for (; first != last; ++first) { _add(*first); }
+    }
+
+    object_traits const& traits() const { return *_traits; }
+
+private:
+    void _add(u8str_view path) {
+        auto const tokens = _internal::split_json_pointer(path);
+
+        auto node   = &_root;
+        auto traits = _traits;
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            auto prop = traits->find_property(tokens[i]);
+            if (prop == nullptr) { throw invalid_property_path_exception{"property not found: " + tokens[i]}; }
+
+            auto const index = prop->memory().index;
+            if (i + 1 == tokens.size()) {
+                node->whole[index] = true;
+                break;
+            }
+
+            if (prop->type() != etype::object) {
+                throw invalid_property_path_exception{"not an embedded object: " + tokens[i]};
+            }
+            if (node->whole[index]) { break; }
+
+            traits = &prop->get_object_traits();
+            if (!node->children[index]) { node->children[index] = std::make_unique<_node>(*traits); }
+            node = node->children[index].get();
+        }
+    }
+
+private:
+    object_traits const* _traits;
+    _node _root;
+};
+
+/**
+ * Parses json string into object.
+ *
+ * In merge mode, fields which don't appear in json are left untouched, and map keys are merged
+ *into existing ones as of JSON merge patch(RFC 7396); null removes the key. Arrays are always
+ *replaced wholesale.
  */
 class json_parse {
 public:
@@ -27,8 +100,76 @@ public:
         jsmn::jsmn_init(&_parse);
     }
 
+    /**
+     * Defers parsing of nested objects and arrays of change-tracked objects, which keeps their
+     *raw JSON in object state instead; they are parsed on first access through reflection, and
+     *dumped as is until then, unless they are dumped in other encodings, into a sidecar, or in
+     *layout which their whitespace doesn't fit. Has no effect in merge mode.
+     */
+    json_parse& defer_nested(bool enabled = true) noexcept {
+        _defer_nested = enabled;
+        return *this;
+    }
+
+    /**
+     * Parses elements of object arrays concurrently on given pool, if the array has at least
+     *min_elements elements. Pool must outlive this parser.
+     */
+    json_parse& parallel(thread_pool& pool, size_t min_elements = 1024) noexcept {
+        _pool = &pool, _parallel_threshold = min_elements;
+        return *this;
+    }
+
+    /**
+     * Reads numeric timestamps in unit of given encoding, unless overridden by property flags.
+     *Timestamps in RFC 3339 strings are accepted regardless.
+     */
+    json_parse& timestamps(timestamp_encoding encoding) noexcept {
+        _timestamps = encoding;
+        return *this;
+    }
+
+    /** Reads binaries in given encoding, unless overridden by property flags. */
+    json_parse& binaries(binary_encoding encoding) noexcept {
+        _binaries = encoding;
+        return *this;
+    }
+
+    /**
+     * Reads blobs of sidecar encoded binaries through given reader. Nested values are never
+     *deferred with sidecar, since the reader is not retained by objects.
+     */
+    json_parse& sidecar(sidecar_reader_t reader) {
+        _sidecar = std::move(reader);
+        return *this;
+    }
+
     std::optional<failure_report> operator()(u8str_view str, object& out) {
-        auto num_tokens = jsmn::jsmn_parse(&_parse, str.data(), str.size(), nullptr, 0);
+        return _parse_object(str, out, nullptr);
+    }
+
+    /** Parses only the properties which are selected by projection. */
+    std::optional<failure_report> operator()(u8str_view str, object& out, json_projection const& projection) {
+        if (&projection.traits() != &out.traits()) {
+            throw std::invalid_argument{"projection was compiled for other type"};
+        }
+        return _parse_object(str, out, &projection._root);
+    }
+
+private:
+    std::optional<failure_report> _parse_object(u8str_view str, object& out, json_projection::_node const* projection) {
+        // token buffer of previous parse is tried first, which spares counting pass in most cases.
+        int num_tokens = jsmn::JSMN_ERROR_NOMEM;
+        if (_buffered.empty() && _tokens.capacity() > 0) {
+            _tokens.resize(_tokens.capacity());
+            jsmn::jsmn_init(&_parse);
+            num_tokens = jsmn::jsmn_parse(&_parse, str.data(), str.size(), _tokens.data(), (unsigned)_tokens.size());
+            jsmn::jsmn_init(&_parse);
+        }
+
+        bool const is_tokenized = num_tokens >= 0;
+        if (!is_tokenized) { num_tokens = jsmn::jsmn_parse(&_parse, str.data(), str.size(), nullptr, 0); }
+
         if (num_tokens == jsmn::JSMN_ERROR_INVAL) {
             return failure_report{failure_report::error_invalid_token};
         } else if (num_tokens == jsmn::JSMN_ERROR_PART) {
@@ -48,14 +189,16 @@ public:
 
         // perform actual parsing
         _tokens.resize(num_tokens);
-        jsmn::jsmn_init(&_parse);
-        jsmn::jsmn_parse(&_parse, ptr, size, _tokens.data(), (unsigned)_tokens.size());
+        if (!is_tokenized) {
+            jsmn::jsmn_init(&_parse);
+            jsmn::jsmn_parse(&_parse, ptr, size, _tokens.data(), (unsigned)_tokens.size());
+        }
 
         // marshal tokenized result into object.
         if (_tokens.size() > 1) { // given result can be empty object; e.g. "{}"
             int idx = 0;          // index 0 is root object
             _str    = str;
-            if (!_marshal(out, idx)) {
+            if (!_marshal(out, idx, -1, projection)) {
                 failure_report report;
                 report.code = failure_report::error_invalid_type;
                 if (idx < _tokens.size()) {
@@ -74,7 +217,166 @@ public:
         return {};
     }
 
-private:
+    /**
+     * Parses deferred raw value of single property, by parsing it as the only member of owner.
+     * Instantiated per encodings, since materializer is plain function.
+     */
+    template <timestamp_encoding Timestamps_, binary_encoding Binaries_>
+    static bool _materialize(object_baseaddr_t* base, property const& prop, u8str_view raw) {
+        struct owner_view : object {
+            object_traits const& traits() const override { return *traits_; }
+            void* _base() override { return base_; }
+            void const* _base() const override { return base_; }
+
+            object_traits const* traits_;
+            object_baseaddr_t* base_;
+        } owner;
+        owner.traits_ = prop.memory().owner, owner.base_ = base;
+
+        u8str doc;
+        doc.reserve(prop.tag().size() + raw.size() + 6);
+        doc.append("{\"").append(prop.tag()).append("\": ").append(raw).append("}");
+        return !json_parse{}.timestamps(Timestamps_).binaries(Binaries_)(doc, owner).has_value();
+    }
+
+    template <size_t... Index_>
+    static constexpr auto _materializers(std::index_sequence<Index_...>) {
+        return std::array<object_state::materializer_t, sizeof...(Index_)>{
+          &_materialize<timestamp_encoding(Index_ % 4), binary_encoding(Index_ / 4)>...};
+    }
+
+    object_state::materializer_t _materializer() const {
+        static constexpr auto table = _materializers(std::make_index_sequence<4 * 4>{});
+        return table[size_t(_timestamps) + size_t(_binaries) * 4];
+    }
+
+    /** Encodings of values of single property; value initialized one designates defaults. */
+    struct _value_encoding {
+        timestamp_encoding timestamps;
+        binary_encoding binaries;
+        sidecar_reader_t const* sidecar;
+    };
+
+    /** Encodings of given property, or of this call if null. */
+    _value_encoding _encoding(property const* prop = nullptr) const {
+        _value_encoding r{_timestamps, _binaries, _sidecar ? &_sidecar : nullptr};
+        if (prop) {
+            r.timestamps = timestamp_encoding_of(*prop, r.timestamps);
+            r.binaries   = binary_encoding_of(*prop, r.binaries);
+        }
+        return r;
+    }
+
+    /** Moves token index past the value of the key token. */
+    void _skip_value(int& token_idx) const {
+        token_idx = token_idx + 1 < _tokens.size() ? _next_sibling(token_idx + 1) : int(_tokens.size());
+    }
+
+    /** Finds index of the first token after given token and all of its descendants. */
+    int _next_sibling(int token_idx) const {
+        // tokens are sorted by start position, thus the first token which starts after the end
+        //of value is next sibling.
+        auto const end = _tokens[token_idx].end;
+        auto it        = std::partition_point(
+          _tokens.begin() + token_idx + 1, _tokens.end(), [end](auto& t) { return t.start < end; });
+        return int(it - _tokens.begin());
+    }
+
+    /**
+     * Parses elements of object array concurrently. Element boundaries are located first, then
+     *each element is parsed into pre-sized slot by the thread pool.
+     */
+    template <typename Proxy_>
+    bool _marshal_parallel(Proxy_& proxy, int& token_idx) const {
+        int const array_idx  = token_idx;
+        auto const num_elems = size_t(_tokens[array_idx].size);
+
+        std::vector<int> elems;
+        elems.reserve(num_elems);
+        for (int idx = array_idx + 1; elems.size() < num_elems; idx = _next_sibling(idx)) {
+            if (_tokens[idx].type != jsmn::JSMN_OBJECT) { return false; }
+            elems.push_back(idx);
+        }
+
+        proxy.reserve(num_elems);
+        for (size_t i = 0; i < num_elems; ++i) { proxy.emplace_back(); }
+
+        std::atomic_bool is_valid = true;
+        _pool->parallel_for(num_elems, [&](size_t i) {
+            auto& obj = proxy[i];
+            int idx   = elems[i];
+            obj.reset();
+            if (!_marshal(obj, idx, array_idx)) { is_valid = false; }
+        });
+
+        token_idx = _next_sibling(array_idx);
+        return is_valid;
+    }
+
+    /** Decodes binary text of given encoding. Returns false if it is malformed. */
+    static bool _parse_binary(u8str_view value, binary_chunk& out, _value_encoding const& encoding) {
+        if (encoding.binaries == binary_encoding::sidecar) {
+            if (encoding.sidecar == nullptr) { throw std::logic_error{"sidecar encoded binary requires sidecar reader"}; }
+
+            uint64_t offset = 0;
+            size_t size     = 0;
+            auto const end  = value.data() + value.size();
+            auto r          = std::from_chars(value.data(), end, offset);
+            if (r.ec != std::errc{} || r.ptr == end || *r.ptr != ':') { return false; }
+            r = std::from_chars(r.ptr + 1, end, size);
+            if (r.ec != std::errc{} || r.ptr != end) { return false; }
+
+            out.resize(size);
+            if (size > 0 && !(*encoding.sidecar)(offset, size, out.data())) { return out.clear(), false; }
+            return true;
+        }
+
+        size_t n;
+        switch (encoding.binaries) {
+            case binary_encoding::hex:
+                out.resize(hex::decoded_size(value.size()));
+                n = hex::decode_to(value.data(), value.size(), out.data());
+                break;
+            case binary_encoding::base85:
+                out.resize(base85::decoded_size(value.size()));
+                n = base85::decode_to(value.data(), value.size(), out.data());
+                break;
+            default:
+                out.resize(base64::decoded_size(value.size()));
+                n = base64::decode_to(value.data(), value.size(), out.data());
+                break;
+        }
+
+        static_assert(hex::invalid == base64::invalid && base85::invalid == base64::invalid);
+        out.resize(n == base64::invalid ? 0 : n);
+        return n != base64::invalid;
+    }
+
+    /**
+     * Overwrites destination with json token value. Strings are unescaped. Timestamps are read
+     *from integers in unit of given encoding, or from RFC 3339 strings.
+     */
+    template <typename Ty_>
+    static void _parse_value(u8str_view value, Ty_& dest, _value_encoding const& encoding = {}) {
+        constexpr etype T = etype::from_type<Ty_>();
+        if constexpr (T.is_timestamp()) {
+            int64_t epoch;
+            auto const r = std::from_chars(value.data(), value.data() + value.size(), epoch);
+            if (encoding.timestamps != timestamp_encoding::iso8601 && r.ec == std::errc{} && r.ptr == value.data() + value.size()) {
+                dest = from_epoch(epoch, encoding.timestamps);
+            } else {
+                generic_parse<Ty_>{}(value.begin(), value.end(), dest);
+            }
+        } else if constexpr (T.is_string()) {
+            u8str& out = dest;
+            out.clear(), utils::json_unescape(value, out);
+        } else if constexpr (T.is_binary()) {
+            _parse_binary(value, dest, encoding);
+        } else {
+            generic_parse<Ty_>{}(value.begin(), value.end(), dest);
+        }
+    }
+
     class _primitive_visitor {
     public:
         template <typename Ty_>
@@ -83,10 +385,10 @@ private:
             if constexpr (T.is_container()) {
                 return false;
             } else if constexpr (T.is_one_of(etype::timestamp, etype::string, etype::binary)) {
-                generic_parse<Ty_>{}(_str.begin(), _str.end(), *dest);
+                _parse_value(_str, *dest, _encoding);
                 return true;
             } else if constexpr (T.is_null() || T.is_number() || T.is_boolean()) {
-                generic_parse<Ty_>{}(_str.begin(), _str.end(), *dest);
+                _parse_value(_str, *dest);
                 return true;
             } else {
                 assert(false);
@@ -94,17 +396,20 @@ private:
             }
         }
 
-        _primitive_visitor(u8str_view s) : _str(s) {}
+        _primitive_visitor(u8str_view s, _value_encoding const& encoding = {}) : _str(s), _encoding(encoding) {}
 
     private:
         u8str_view _str;
+        _value_encoding _encoding;
     };
 
-    bool _marshal(object& out, int& token_idx, int const parent_idx = -1) const {
+    bool _marshal(object& out, int& token_idx, int const parent_idx = -1,
+                  json_projection::_node const* projection = nullptr) const {
         // when entering this function, token_idx
 
         auto baseaddr        = out.base();
         auto& traits         = out.traits();
+        auto state           = _defer_nested && !_merge_mode && !_sidecar ? out.state() : nullptr;
         int self_idx         = token_idx;
         property const* prop = nullptr;
 
@@ -126,25 +431,75 @@ private:
                               utils::remove_suffix_if_found(token_value, ATTR_SUFFIX);
                             propname_if_attr.empty() == false) //
                         {
-                            // TODO: if it's attribute ...
+                            // attribute block; "Tag~@@ATTR@@": { "Attribute": value, ... }
+                            auto owner = traits.find_property(propname_if_attr);
+                            if (owner && projection && !projection->selects(owner->memory().index)) {
+                                owner = nullptr;
+                            }
+                            int const block_idx = ++token_idx;
+                            if (block_idx >= _tokens.size() || _tokens[block_idx].type != jsmn::JSMN_OBJECT) {
+                                return false;
+                            }
+
+                            for (++token_idx; token_idx + 1 < _tokens.size() && _tokens[token_idx].parent == block_idx;
+                                 token_idx += 2) //
+                            {
+                                auto& name_tk  = _tokens[token_idx];
+                                auto& value_tk = _tokens[token_idx + 1];
+                                if (value_tk.type == jsmn::JSMN_OBJECT || value_tk.type == jsmn::JSMN_ARRAY) {
+                                    return false;
+                                }
+
+                                // attributes which don't exist are ignored, as same as tags.
+                                if (owner == nullptr) { continue; }
+                                auto name  = _str.substr(name_tk.start, name_tk.end - name_tk.start);
+                                auto value = _str.substr(value_tk.start, value_tk.end - value_tk.start);
+
+                                auto& attrs = owner->attributes();
+                                auto attr   = std::find_if(attrs.begin(), attrs.end(), [&](auto& a) { return a.name == name; });
+                                if (attr == attrs.end()) { continue; }
+
+                                if (!visit_property(baseaddr, *attr, _primitive_visitor{value, _encoding()})) {
+                                    return false;
+                                }
+                            }
+
+                            continue;
                         } else {
                             prop = traits.find_property(token_value);
-                            if (prop == nullptr) {
-                                // if given tag does not exist, ignore all child tokens.
-                                // if any token's parent index is LE with current, it is sibling or
-                                //unrelated node of this.
-                                for (auto cur_super = token.parent;
-                                     ++token_idx < _tokens.size() && is_token_child_of(cur_super);) //
-                                {}
+                            if (prop && projection && !projection->selects(prop->memory().index)) {
+                                prop = nullptr;
+                            }
 
+                            if (prop == nullptr) {
+                                // if given tag does not exist or is not projected, ignore all child tokens.
+                                _skip_value(token_idx);
                                 continue;
                             }
+
+                            if (state && token_idx + 1 < _tokens.size()) {
+                                auto& value_tk = _tokens[token_idx + 1];
+                                bool const is_nested
+                                  = (value_tk.type == jsmn::JSMN_OBJECT && (prop->type() == etype::object || prop->type().is_map()))
+                                    || (value_tk.type == jsmn::JSMN_ARRAY && prop->type().is_array());
+
+                                if (is_nested) {
+                                    // previously deferred value is applied first, as embedded objects are
+                                    //updated rather than replaced.
+                                    if (prop->type() == etype::object) { materialize(baseaddr, *prop); }
+                                    auto raw = _str.substr(value_tk.start, value_tk.end - value_tk.start);
+                                    state->defer(prop->memory().index, raw, _materializer(), encoding_key(_timestamps, _binaries));
+                                    mark_dirty(baseaddr, prop->memory());
+                                    _skip_value(token_idx);
+                                    continue;
+                                }
+                            }
                         }
                     } else if (prop->type().is_one_of(etype::binary, etype::string, etype::timestamp)) {
                         // these 3 types are represented as JSON string.
 
                         assert(prop);
-                        visit_property(baseaddr, *prop, _primitive_visitor{token_value});
+                        visit_property(baseaddr, *prop, _primitive_visitor{token_value, _encoding(prop)});
                         prop = nullptr;
                     } else {
                         return false;
@@ -154,23 +509,20 @@ private:
                 case jsmn::JSMN_OBJECT:
                     assert(prop);
                     if (prop->type().is_map()) {
-                        // TODO
                         // since object map shares structure with general json object,
                         //this token can indicate any map property.
-                        if (prop->type().is_object()) {
-                            // iterate all children tags
-                            // value type should be object
-                            // call _marshal() recursively.
-                            auto proxy = make_proxy<u8str_map<object>>(baseaddr, *prop);
-                        } else { // if it is map of primitive type ...
-                            // iterate all children tags
-                            // value type should be primitive or string
+                        auto const encoding = _encoding(prop);
+                        if (!visit_property(baseaddr, *prop, [&](auto proxy) { return _marshal_map(proxy, token_idx, encoding); })) {
+                            return false;
                         }
+                        prop = nullptr;
+                        continue;
                     } else if (prop->type() == etype::object) {
                         auto proxy = make_proxy<object>(baseaddr, *prop);
 
                         // recursively parse child json object
-                        if (!_marshal(*proxy, token_idx, self_idx)) { return false; }
+                        auto child_projection = projection ? projection->child(prop->memory().index) : nullptr;
+                        if (!_marshal(*proxy, token_idx, self_idx, child_projection)) { return false; }
                         prop = nullptr;
                         continue;
                     } else {
@@ -185,51 +537,111 @@ private:
                     }
 
                     // visit each array element, then parse.
-                    visit_property(baseaddr, *prop, [&](auto proxy) {
+                    if (!visit_property(baseaddr, *prop, [&, encoding = _encoding(prop)](auto proxy) {
                         constexpr etype T = proxy.type();
 
+                        using proxy_type = decltype(proxy);
+
                         if constexpr (!T.is_array()) {
                             return false;
-                        } else {
-                            using value_type = typename etype::to_type_t<T>::value_type;
-                            if (!_merge_mode) { proxy.erase(0, proxy.size()); }
+                        } else if constexpr (etype::layout_from_type<typename proxy_type::Ty_>() == elayout::fixed) {
+                            // fixed arrays can't be resized; elements are assigned by index.
+                            using value_type = typename proxy_type::value_type;
+                            size_t index     = 0;
+
+                            for (auto initial_parent = token.parent;
+                                 ++token_idx < _tokens.size() && is_token_child_of(initial_parent);
+                                 ++index) //
+                            {
+                                if (index >= proxy.size()) { return false; }
+
+                                auto& tk   = _tokens[token_idx];
+                                auto value = u8str_view{
+                                  _str.data() + tk.start, size_t(tk.end - tk.start)};
+                                _parse_value<value_type>(value, proxy[index], encoding);
+                            }
+
+                            // omitted elements are reset even in merge mode, as arrays are replaced wholesale.
+                            for (; index < proxy.size(); ++index) { proxy[index] = value_type{}; }
+                            return true;
+                        } else if constexpr (etype::layout_from_type<typename proxy_type::Ty_>() == elayout::nested) {
+                            // rows are direct child arrays, of which elements are appended into the last row.
+                            using value_type = typename proxy_type::value_type;
+                            int const array_idx = token_idx;
+                            proxy.erase(0, proxy.size());
 
                             for (auto initial_parent = token.parent;
                                  ++token_idx < _tokens.size() && is_token_child_of(initial_parent);) //
                             {
-                                if constexpr (T.is_object()) {
-                                    // parse object array elements
-                                    if (_tokens[token_idx].type != jsmn::JSMN_OBJECT) {
-                                        return false;
-                                    }
-                                    auto& obj = proxy.emplace_back();
-                                    if (!_marshal(obj, token_idx, token_idx)) {
-                                        return false;
-                                    }
-                                } else {
-                                    // parse primitive elements
-                                    auto& tk   = _tokens[token_idx];
+                                auto& tk = _tokens[token_idx];
+                                if (tk.parent == array_idx) {
+                                    if (tk.type != jsmn::JSMN_ARRAY) { return false; }
+                                    proxy.emplace_back();
+                                } else if (tk.type == jsmn::JSMN_PRIMITIVE || tk.type == jsmn::JSMN_STRING) {
                                     auto value = u8str_view{
                                       _str.data() + tk.start, size_t(tk.end - tk.start)};
 
-                                    generic_parse<value_type>{}(
-                                      value.begin(), value.end(),
-                                      proxy.emplace_back());
+                                    value_type elem;
+                                    _parse_value(value, elem, encoding);
+                                    proxy->append(std::move(elem));
+                                } else {
+                                    return false;
                                 }
                             }
                             return true;
+                        } else if constexpr (T.is_object()) {
+                            int const array_idx = token_idx;
+                            proxy.erase(0, proxy.size());
+
+                            if (_pool && _pool->size() > 0 && _tokens[array_idx].size >= _parallel_threshold) {
+                                return _marshal_parallel(proxy, token_idx);
+                            }
+
+                            // each element object consumes all of its child tokens, thus token index
+                            //already points next element after recursion.
+                            for (++token_idx; token_idx < _tokens.size() && _tokens[token_idx].parent == array_idx;) {
+                                if (_tokens[token_idx].type != jsmn::JSMN_OBJECT) {
+                                    return false;
+                                }
+
+                                auto& obj = proxy.emplace_back();
+                                obj.reset();
+                                if (!_marshal(obj, token_idx, array_idx)) {
+                                    return false;
+                                }
+                            }
+                            return true;
+                        } else {
+                            proxy.erase(0, proxy.size());
+
+                            for (auto initial_parent = token.parent;
+                                 ++token_idx < _tokens.size() && is_token_child_of(initial_parent);) //
+                            {
+                                // parse primitive elements
+                                auto& tk   = _tokens[token_idx];
+                                auto value = u8str_view{
+                                  _str.data() + tk.start, size_t(tk.end - tk.start)};
+
+                                // bit-packed arrays yield proxy reference instead of actual one.
+                                decltype(auto) elem = proxy.emplace_back();
+                                _parse_value<std::remove_reference_t<decltype(elem)>>(value, elem, encoding);
+                            }
+                            return true;
                         }
-                    });
+                    })) {
+                        return false;
+                    }
+                    prop = nullptr;
                     continue;
 
                 case jsmn::JSMN_PRIMITIVE:
                     assert(prop);
                     if (prop->type().is_container() ||
                         !prop->type().is_one_of(
-                          etype::boolean, etype::null, etype::integer, etype::floating_point)) //
+                          etype::boolean, etype::null, etype::integer, etype::floating_point, etype::timestamp)) //
                     {
                         return false;
-                    } else if (!visit_property(baseaddr, *prop, _primitive_visitor{token_value})) {
+                    } else if (!visit_property(baseaddr, *prop, _primitive_visitor{token_value, _encoding(prop)})) {
                         return false;
                     }
                     prop = nullptr;
@@ -244,7 +656,47 @@ private:
         return true;
     }
 
-    void _marshal_attributes() const {}
+    template <typename Proxy_>
+    bool _marshal_map(Proxy_ proxy, int& token_idx, _value_encoding const& encoding) const {
+        constexpr etype T = proxy.type();
+
+        if constexpr (!T.is_map()) {
+            return false;
+        } else {
+            int const map_idx = token_idx;
+            if (!_merge_mode) { proxy.clear(); }
+
+            for (++token_idx; token_idx + 1 < _tokens.size() && _tokens[token_idx].parent == map_idx;) {
+                auto& key_tk   = _tokens[token_idx];
+                auto& value_tk = _tokens[++token_idx];
+                auto key       = _str.substr(key_tk.start, key_tk.end - key_tk.start);
+                auto value     = _str.substr(value_tk.start, value_tk.end - value_tk.start);
+
+                if (value_tk.type == jsmn::JSMN_PRIMITIVE && value == "null") {
+                    // as of JSON merge patch, null removes the key.
+                    proxy.erase(key), ++token_idx;
+                    continue;
+                }
+
+                if constexpr (T.is_object()) {
+                    if (value_tk.type != jsmn::JSMN_OBJECT) { return false; }
+
+                    auto found = proxy.find(key);
+                    auto& obj  = found ? *found : proxy.insert(key);
+                    if (found == nullptr) { obj.reset(); }
+
+                    if (!_marshal(obj, token_idx, map_idx)) { return false; }
+                } else {
+                    if (value_tk.type == jsmn::JSMN_OBJECT || value_tk.type == jsmn::JSMN_ARRAY) { return false; }
+
+                    using mapped_type = typename Proxy_::mapped_type;
+                    _parse_value<mapped_type>(value, proxy.insert(key), encoding);
+                    ++token_idx;
+                }
+            }
+            return true;
+        }
+    }
 
 private:
     jsmn::jsmn_parser _parse = {};
@@ -253,6 +705,13 @@ private:
     u8str_view _str;
     object* _pout;
     bool _merge_mode;
+    bool _defer_nested = false;
+    timestamp_encoding _timestamps = timestamp_encoding::iso8601;
+    binary_encoding _binaries      = binary_encoding::base64;
+    sidecar_reader_t _sidecar;
+
+    thread_pool* _pool         = nullptr;
+    size_t _parallel_threshold = 0;
 };
 
 } // namespace kangsw::refl::marshal
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <charconv>
 #include <utility>
 #include "kangsw/markup/types.hxx"
 
@@ -66,8 +67,62 @@ inline u8str_view remove_suffix_if_found(u8str_view s, u8str_view find) {
         return {};
     } else {
         return s.substr(s.size() - find.size()) == find
-                 ? s.substr(0, s.size() - find.size() + 1)
+                 ? s.substr(0, s.size() - find.size())
                  : u8str_view{};
     }
 }
+/** Decodes escape sequences of json string, then appends result to out. */
+inline void json_unescape(u8str_view in, u8str& out) {
+    auto const append_utf8 = [&out](uint32_t cp) {
+        if (cp < 0x80) {
+            out += char(cp);
+        } else if (cp < 0x800) {
+            out += char(0xc0 | (cp >> 6)), out += char(0x80 | (cp & 0x3f));
+        } else if (cp < 0x10000) {
+            out += char(0xe0 | (cp >> 12)), out += char(0x80 | ((cp >> 6) & 0x3f)), out += char(0x80 | (cp & 0x3f));
+        } else {
+            out += char(0xf0 | (cp >> 18)), out += char(0x80 | ((cp >> 12) & 0x3f));
+            out += char(0x80 | ((cp >> 6) & 0x3f)), out += char(0x80 | (cp & 0x3f));
+        }
+    };
+
+    auto const read_hex4 = [&in](size_t at, uint32_t& cp) {
+        if (at + 4 > in.size()) { return false; }
+        auto r = std::from_chars(in.data() + at, in.data() + at + 4, cp, 16);
+        return r.ec == std::errc{} && r.ptr == in.data() + at + 4;
+    };
+
+    out.reserve(out.size() + in.size());
+    for (size_t i = 0; i < in.size(); ++i) {
+        if (in[i] != '\\' || i + 1 == in.size()) {
+            out += in[i];
+            continue;
+        }
+
+        switch (char const ch = in[++i]) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t cp = 0, low = 0;
+                if (!read_hex4(i + 1, cp)) {
+                    out += "\\u";
+                    break;
+                }
+                i += 4;
+
+                // combine surrogate pair
+                if (0xd800 <= cp && cp < 0xdc00 && i + 2 < in.size() && in[i + 1] == '\\' && in[i + 2] == 'u'
+                    && read_hex4(i + 3, low) && 0xdc00 <= low && low < 0xe000) {
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                    i += 6;
+                }
+                append_utf8(cp);
+            } break;
+            default: out += ch; break; // '"', '\\', '/'
+        }
+    }
+}
 } // namespace kangsw::refl::marshal::utils
@@ -5,6 +5,7 @@
 #include <iostream>
 #include "kangsw/markup/types.hxx"
 #include "kangsw/markup/utility/base64.hxx"
+#include "kangsw/markup/utility/timestamp.hxx"
 
 namespace kangsw::refl::marshal
 {
@@ -65,8 +66,7 @@ template <typename Ty_> size_t genenric_predict_buffer_length<Ty_>::operator()(T
     } else if constexpr (type.is_null()) {
         return 4;
     } else if constexpr (type.is_timestamp()) {
-        char const fmt[] = "YYYY-MM-DDThh:mm:ss.SSSZ";
-        return sizeof fmt;
+        return timestamp::max_formatted_size;
     } else {
         return 0;
     }
@@ -91,26 +91,13 @@ template <typename Ty_> template <typename OutIt_> void generic_stringfy<Ty_>::o
         char constexpr str[] = "null";
         std::copy(str, str + 4, o);
     } else if constexpr (type.is_timestamp()) {
-        // yyyy-mm-ddThh:MM:ss+hh:MM
-        timestamp_t const& t = i;
-        using namespace std::chrono;
-        auto time = timestamp_t::clock::to_time_t(t);
-        auto tm   = *gmtime(&time);
-        int frac  = duration_cast<milliseconds>(t.time_since_epoch()).count() % 1000;
-        char buf[25];
-        auto len = snprintf(buf, sizeof buf, "%4d-%02d-%02dT%02d:%02d:%02d.%03dZ",
-                            tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
-                            tm.tm_hour, tm.tm_min, tm.tm_sec, frac);
-        std::copy(buf, buf + len, o);
+        char buf[timestamp::max_formatted_size];
+        std::copy(buf, timestamp::format(buf, i), o);
     } else {
         static_assert("This type can't be trivially stringfy-ied");
     }
 }
 
-#if _WIN32 // Cross-platform support
-inline time_t timegm(tm* t) { return _mkgmtime(t); }
-#endif
-
 template <typename Ty_> char const* generic_parse<Ty_>::_impl(char const* begin, char const* end, Ty_& dest) const {
     auto constexpr type = etype::from_type<Ty_>();
     auto const maxlen   = end - begin;
@@ -131,10 +118,14 @@ template <typename Ty_> char const* generic_parse<Ty_>::_impl(char const* begin,
         return nullptr;
     } else if constexpr (type.is_binary()) {
         binary_chunk& out = dest;
-        out.reserve(out.size() + base64::decoded_size(maxlen));
-        if (base64::decode(begin, end, std::back_inserter(out))) {
+        auto const offset = out.size();
+        out.resize(offset + base64::decoded_size(maxlen));
+
+        if (auto const n = base64::decode_to(begin, maxlen, out.data() + offset); n != base64::invalid) {
+            out.resize(offset + n);
             return end;
         } else {
+            out.resize(offset);
             return nullptr;
         }
     } else if constexpr (type.is_string()) {
@@ -148,55 +139,8 @@ template <typename Ty_> char const* generic_parse<Ty_>::_impl(char const* begin,
             return nullptr;
         }
     } else if constexpr (type.is_timestamp()) {
-        //                             0    5  8  11 14 17 20 23
-        static char constexpr fmt[] = "YYYY-MM-DDThh:mm:ss.SSSZ";
-
-        auto const get_int = [begin](size_t from, size_t to) -> std::optional<int> {
-            int value;
-            std::from_chars_result c = std::from_chars(begin + from, begin + to, value);
-            if (c.ec == std::errc{}) {
-                return value;
-            } else {
-                return {};
-            }
-        };
-
-        tm tm;
-        const std::pair<int*, std::pair<size_t /*from*/, size_t /*to*/>> assigns[] = {
-          {&tm.tm_year, {0, 4}},
-          {&tm.tm_mon, {5, 7}},
-          {&tm.tm_mday, {8, 10}},
-          {&tm.tm_hour, {11, 13}},
-          {&tm.tm_min, {14, 16}},
-          {&tm.tm_sec, {17, 19}}};
-
-        for (auto [target, pair] : assigns) {
-            auto [from, to] = pair;
-            auto ovalue     = get_int(from, to);
-            if (ovalue) {
-                *target = *ovalue;
-            } else {
-                return nullptr;
-            }
-        }
-
-        tm.tm_year -= 1900, tm.tm_mon -= 1;
-
         timestamp_t& out = dest;
-        time_t time      = timegm(&tm);
-        out              = timestamp_t::clock::from_time_t(time);
-
-        // Milliseconds should treated specially.
-        if (begin[20] != 'Z') {
-            if (auto ovalue = get_int(20, 23)) {
-                std::chrono::milliseconds milli{*ovalue};
-                out += milli;
-            }
-
-            return begin[23] == 'Z' ? begin + 24 : nullptr;
-        } else {
-            return begin[19] == 'Z' ? begin + 20 : nullptr;
-        }
+        return timestamp::parse(begin, end, out);
     } else {
         static_assert("This type can't be trivially stringfy-ied");
         return nullptr;
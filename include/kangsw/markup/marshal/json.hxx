@@ -3,3 +3,7 @@
 #include "details/json_dump.hxx"
 #include "details/json_parse.hxx"
 #include "details/json_parser_stream.hxx"
+#include "details/json_diff.hxx"
+#include "details/json_ingest_pipeline.hxx"
+#include "details/json_file.hxx"
+#include "details/json_async.hxx"
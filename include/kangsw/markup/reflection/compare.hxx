@@ -0,0 +1,250 @@
+#pragma once
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include "property_proxy.hxx"
+
+namespace kangsw::refl {
+
+namespace _internal {
+/** Types of which equality is same as equality of their memory representation. */
+template <typename Ty_>
+constexpr bool _is_bitwise_comparable_v = std::is_integral_v<Ty_>
+                                          || std::is_same_v<Ty_, std::byte>
+                                          || std::is_same_v<Ty_, boolean_t>
+                                          || std::is_same_v<Ty_, timestamp_t>;
+
+/** Single byte types which memcmp() orders correctly. */
+template <typename Ty_>
+constexpr bool _is_byte_ordered_v = std::is_same_v<Ty_, char>
+                                    || std::is_same_v<Ty_, unsigned char>
+                                    || std::is_same_v<Ty_, std::byte>;
+
+inline bool _is_bitwise_comparable(property const& prop) {
+    auto& m = prop.memory();
+    if (!prop.attributes().empty()) { return false; }
+    if (m.type.is_container() && !(m.type.is_array() && m.layout == elayout::fixed)) { return false; }
+    return m.type.is_one_of(etype::boolean, etype::integer, etype::timestamp);
+}
+
+template <typename Ty_>
+int _three_way(Ty_ const& a, Ty_ const& b) { return (b < a) - (a < b); }
+
+template <bool EqOnly_>
+int _compare(object const& a, object const& b);
+
+template <bool EqOnly_, typename Ty_>
+int _compare_range(Ty_ const* a, size_t na, Ty_ const* b, size_t nb);
+
+template <bool EqOnly_, typename Ty_>
+int _compare(Ty_ const& a, Ty_ const& b) {
+    constexpr auto T = etype::from_type<Ty_>();
+
+    if constexpr (T.is_null()) {
+        return 0;
+    } else if constexpr (T.is_floating_point()) {
+        // NaN is treated as equal to itself, and greater than any other number.
+        if (std::isnan(a) || std::isnan(b)) { return std::isnan(a) - std::isnan(b); }
+        return _three_way(a, b);
+    } else if constexpr (T.is_string() || T.is_binary() || T.is_array()) {
+        return _compare_range<EqOnly_>(a.data(), a.size(), b.data(), b.size());
+    } else {
+        return _three_way<std::conditional_t<T.is_boolean(), bool, Ty_>>(a, b);
+    }
+}
+
+/** Compares two ranges lexicographically. Bitwise comparable ranges are tested by memcmp() first. */
+template <bool EqOnly_, typename Ty_>
+int _compare_range(Ty_ const* a, size_t na, Ty_ const* b, size_t nb) {
+    if constexpr (_is_bitwise_comparable_v<Ty_>) {
+        if (na == nb && (na == 0 || memcmp(a, b, na * sizeof(Ty_)) == 0)) { return 0; }
+        if constexpr (EqOnly_) { return 1; }
+
+        if constexpr (_is_byte_ordered_v<Ty_>) {
+            auto const n = std::min(na, nb);
+            if (auto r = n ? memcmp(a, b, n) : 0) { return (r > 0) - (r < 0); }
+        } else {
+            for (size_t i = 0, n = std::min(na, nb); i < n; ++i) {
+                if (auto r = _three_way(a[i], b[i])) { return r; }
+            }
+        }
+    } else {
+        if (EqOnly_ && na != nb) { return 1; }
+
+        for (size_t i = 0, n = std::min(na, nb); i < n; ++i) {
+            if (auto r = _compare<EqOnly_>(a[i], b[i])) { return r; }
+        }
+    }
+
+    return _three_way(na, nb);
+}
+
+inline int _compare_bits(bit_vector const& a, bit_vector const& b) {
+    auto const n = std::min(a.size(), b.size());
+    auto &wa = a.words(), &wb = b.words();
+
+    size_t i = 0;
+    for (; i + bit_vector::word_bits <= n && wa[i / bit_vector::word_bits] == wb[i / bit_vector::word_bits];) {
+        i += bit_vector::word_bits;
+    }
+    for (; i < n; ++i) {
+        if (a.test(i) != b.test(i)) { return a.test(i) ? 1 : -1; }
+    }
+    return _three_way(a.size(), b.size());
+}
+
+template <bool EqOnly_, typename Ty_>
+int _compare(property_proxy<Ty_, true> a, property_proxy<Ty_, true> b) {
+    constexpr auto T = etype::from_type<Ty_>();
+
+    if constexpr (!T.is_container()) {
+        return _compare<EqOnly_>(*a, *b);
+    } else if constexpr (templates::is_specialization_of<Ty_, std::vector>::value && !T.is_object()) {
+        return _compare_range<EqOnly_>(a->data(), a->size(), b->data(), b->size());
+    } else if constexpr (templates::is_specialization_of<Ty_, small_vector_base>::value) {
+        return _compare_range<EqOnly_>(a->data(), a->size(), b->data(), b->size());
+    } else if constexpr (templates::is_specialization_of<Ty_, fixed_array_t>::value) {
+        return _compare_range<EqOnly_>(a.begin(), a.size(), b.begin(), b.size());
+    } else if constexpr (std::is_same_v<Ty_, bit_vector>) {
+        if constexpr (EqOnly_) { return *a != *b; }
+        return _compare_bits(*a, *b);
+    } else if constexpr (templates::is_specialization_of<Ty_, nested_vector>::value) {
+        if constexpr (EqOnly_) {
+            auto &oa = a->offsets(), &ob = b->offsets();
+            auto &va = a->values(), &vb = b->values();
+            return _compare_range<true>(oa.data(), oa.size(), ob.data(), ob.size())
+                   || _compare_range<true>(va.data(), va.size(), vb.data(), vb.size());
+        }
+
+        for (size_t i = 0, n = std::min(a.size(), b.size()); i < n; ++i) {
+            auto ra = a[i], rb = b[i];
+            auto r  = _compare_range<false>(ra.empty() ? nullptr : &ra[0], ra.size(),
+                                            rb.empty() ? nullptr : &rb[0], rb.size());
+            if (r) { return r; }
+        }
+        return _three_way(a.size(), b.size());
+    } else if constexpr (T.is_array()) { // object array
+        if (EqOnly_ && a.size() != b.size()) { return 1; }
+
+        for (size_t i = 0, n = std::min(a.size(), b.size()); i < n; ++i) {
+            if (auto r = _compare<EqOnly_>(a[i], b[i])) { return r; }
+        }
+        return _three_way(a.size(), b.size());
+    } else if constexpr (EqOnly_) { // map
+        if (a.size() != b.size()) { return 1; }
+
+        int r = 0;
+        a.for_each([&](u8str_view key, auto const& value) {
+            if (r) { return; }
+            auto found = b.find(key);
+            r          = found ? _compare<true>(value, *found) : 1;
+        });
+        return r;
+    } else {
+        // entries of both maps are visited in key order, then compared pairwise.
+        using mapped_type = typename property_proxy<Ty_, true>::mapped_type;
+        std::vector<std::pair<u8str_view, mapped_type const*>> rhs;
+        rhs.reserve(b.size());
+        b.for_each([&](u8str_view key, auto const& value) { rhs.emplace_back(key, &value); });
+
+        int r    = 0;
+        size_t i = 0;
+        a.for_each([&](u8str_view key, auto const& value) {
+            if (r) { return; }
+            if (i == rhs.size()) { r = 1; return; }
+
+            auto& [rkey, rvalue] = rhs[i++];
+            r = _three_way(key.compare(rkey), 0);
+            if (r == 0) { r = _compare<false>(value, *rvalue); }
+        });
+        return r ? r : _three_way(i, rhs.size());
+    }
+}
+
+template <bool EqOnly_>
+int _compare_property(object const& a, object const& b, property const& prop) {
+    int r = visit_property(a.base(), prop, [&](auto pa) {
+        return _compare<EqOnly_>(pa, decltype(pa){prop, b[prop]});
+    });
+
+    for (auto& attr : prop.attributes()) {
+        if (r) { break; }
+        r = visit_property(a.base(), attr, [&](auto pa) {
+            return _compare<EqOnly_>(*pa, *decltype(pa){attr, b[attr]});
+        });
+    }
+
+    return r;
+}
+
+template <bool EqOnly_>
+int _compare(object const& a, object const& b) {
+    // deferred values are parsed first, thus memory compared below never holds stale defaults.
+    materialize(a), materialize(b);
+
+    auto& props  = a.properties();
+    auto const x = reinterpret_cast<char const*>(a.base());
+    auto const y = reinterpret_cast<char const*>(b.base());
+
+    for (size_t i = 0; i < props.size();) {
+        // bitwise comparable properties which are laid out next to each other are compared at once.
+        size_t end = i, run_bytes = 0;
+        auto const run_offset = props[i].memory().offset;
+        for (; end < props.size() && _is_bitwise_comparable(props[end]); ++end) {
+            if (props[end].memory().offset != run_offset + run_bytes) { break; }
+            run_bytes += props[end].memory().size;
+        }
+
+        if (end == i) {
+            if (auto r = _compare_property<EqOnly_>(a, b, props[i++])) { return r; }
+            continue;
+        }
+
+        if (memcmp(x + run_offset, y + run_offset, run_bytes) == 0) {
+            i = end;
+            continue;
+        }
+
+        if constexpr (EqOnly_) { return 1; }
+
+        // ordering is resolved by the first property which differs.
+        for (; i < end; ++i) {
+            if (auto r = _compare_property<false>(a, b, props[i])) { return r; }
+        }
+    }
+
+    return 0;
+}
+} // namespace _internal
+
+/**
+ * Tests if two objects have identical content, without serializing them.
+ *
+ * Objects of different types are never equal. Floating point values are compared by value,
+ *except NaN equals to NaN. Deferred values of both objects are parsed before comparison.
+ */
+inline bool equal(object const& a, object const& b) {
+    return &a.traits() == &b.traits() && _internal::_compare<true>(a, b) == 0;
+}
+
+/**
+ * Three-way comparison of two objects of same type. Returns negative value if a < b, zero if
+ *a and b are equal, or positive value otherwise.
+ *
+ * Properties are compared lexicographically in registration order, and each attribute follows
+ *its property. Arrays, strings and map entries are compared lexicographically too.
+ */
+inline int compare(object const& a, object const& b) {
+    if (&a.traits() != &b.traits()) {
+        throw std::invalid_argument{"Objects of different type can't be compared."};
+    }
+
+    return _internal::_compare<false>(a, b);
+}
+
+/** Strict weak ordering of objects, i.e. for sorting or ordered containers. */
+struct object_less {
+    bool operator()(object const& a, object const& b) const { return compare(a, b) < 0; }
+};
+
+} // namespace kangsw::refl
@@ -1,9 +1,330 @@
 #pragma once
-#include "object.hxx"
+#include <mutex>
+#include <new>
+#include <typeindex>
+#include "property_proxy.hxx"
+#include "../utility/object_pool.hxx"
 
 namespace kangsw::refl {
+class dynamic_object;
 
-/** TODO: A object class which can dynamically edit properties on runtime. */
-class dynamic_object : public object {};
+/**
+ * Immutable traits of dynamic objects, which is shared by every object of same property set.
+ *
+ * Shapes form a tree from the empty root shape; adding a property to an object transits its
+ *shape into a child, which is created once then cached in parent. Thus objects which add same
+ *properties in same order always share single shape, as hidden classes of script engines do.
+ *
+ * Property values are laid out in order of addition, thus offsets of a shape are preserved in
+ *all of its descendants. Newly added properties are value-initialized.
+ */
+class dynamic_shape final : public object_traits {
+    friend class dynamic_object;
+
+    /** Lifetime operations of single property value */
+    struct _value_ops {
+        std::type_index type;
+        void (*construct)(void*);
+        void (*copy)(void*, void const*);
+        void (*move)(void*, void*) noexcept;
+        void (*destroy)(void*) noexcept;
+
+        template <typename Ty_>
+        static _value_ops const& get() {
+            static _value_ops const ops{
+              typeid(Ty_),
+              [](void* p) { new (p) Ty_{}; },
+              [](void* p, void const* src) { new (p) Ty_(*static_cast<Ty_ const*>(src)); },
+              [](void* p, void* src) noexcept { new (p) Ty_(std::move(*static_cast<Ty_*>(src))); },
+              [](void* p) noexcept { static_cast<Ty_*>(p)->~Ty_(); }};
+            return ops;
+        }
+    };
+
+    struct _transition {
+        u8str tag;
+        std::type_index type;
+        std::unique_ptr<dynamic_shape> shape;
+    };
+
+public:
+    /** Shape of objects without any property */
+    static dynamic_shape const& root() {
+        static dynamic_shape const shape{nullptr};
+        return shape;
+    }
+
+    /** Retrieves shape which has one more property of given tag and type. */
+    template <typename Ty_>
+    dynamic_shape const& with(u8str_view tag) const {
+        static_assert(!etype::from_type<Ty_>().is_object(), "object property is not supported in dynamic object.");
+        static_assert(alignof(Ty_) <= alignof(std::max_align_t));
+        auto& ops = _value_ops::get<Ty_>();
+
+        std::lock_guard _{_transitions_lock};
+        for (auto& t : _transitions) {
+            if (t.type == ops.type && t.tag == tag) { return *t.shape; }
+        }
+
+        auto shape = std::unique_ptr<dynamic_shape>{new dynamic_shape{this}};
+        auto const offset = (_size + alignof(Ty_) - 1) / alignof(Ty_) * alignof(Ty_);
+
+        property::memory_t m;
+        m.type    = etype::from_type<Ty_>();
+        m.subtype = etype::subtype_from_type<Ty_>();
+        m.layout  = etype::layout_from_type<Ty_>();
+        m.size    = sizeof(Ty_);
+        m.offset  = offset;
+        m.init_fn = [](void* pv) { *(Ty_*)pv = Ty_{}; };
+        shape->_add(tag, std::move(m), ops);
+
+        shape->_size      = offset + sizeof(Ty_);
+        shape->_alignment = std::max(_alignment, alignof(Ty_));
+
+        return *_transitions.emplace_back(_transition{u8str(tag), ops.type, std::move(shape)}).shape;
+    }
+
+    dynamic_shape const* parent() const { return _parent; }
+
+    /** Size of value buffer of objects of this shape */
+    size_t size() const { return _size; }
+    size_t alignment() const { return _alignment; }
+
+public:
+    u8str_view name() const override { return {}; }
+    std::unique_ptr<object> create_empty_object() override;
+    pooled_object acquire_object() const override;
+    void release_object(object* p) const noexcept override;
+
+private:
+    explicit dynamic_shape(dynamic_shape const* parent) : _parent(parent) {
+        if (parent == nullptr) { return; }
+
+        for (size_t i = 0; i < parent->props().size(); ++i) {
+            _add(parent->props()[i].tag(), property::memory_t(parent->props()[i].memory()), *parent->_ops[i]);
+        }
+        _size      = parent->_size;
+        _alignment = parent->_alignment;
+    }
+
+    void _add(u8str_view tag, property::memory_t&& m, _value_ops const& ops) {
+        auto& prop = find_or_add_property(tag);
+        m.owner    = this;
+        m.index    = &prop - props().data();
+        prop._set_defaults("", {}, std::move(m));
+        _ops.push_back(&ops);
+    }
+
+private:
+    dynamic_shape const* _parent;
+    std::vector<_value_ops const*> _ops;
+    size_t _size      = 0;
+    size_t _alignment = 1;
+
+    mutable std::mutex _transitions_lock;
+    mutable std::vector<_transition> _transitions;
+};
+
+/**
+ * Object of which properties can be added in runtime.
+ *
+ * Property metadata is held by shared \ref dynamic_shape, and values are stored in single
+ *buffer of the object, which is placed inline unless it exceeds inline_capacity.
+ */
+class dynamic_object : public object {
+public:
+    static constexpr size_t inline_capacity = 64;
+
+public:
+    dynamic_object() noexcept = default;
+    explicit dynamic_object(dynamic_shape const& shape) { _reshape(shape); }
+
+    dynamic_object(dynamic_object const& other) : dynamic_object() { *this = other; }
+    dynamic_object(dynamic_object&& other) noexcept : dynamic_object() { *this = std::move(other); }
+
+    dynamic_object& operator=(dynamic_object const& other) {
+        if (this == &other) { return *this; }
+        _clear(), _reserve(other._shape->size());
+
+        auto& ops = other._shape->_ops;
+        for (size_t i = 0; i < ops.size(); ++i) {
+            auto offset = other._shape->props()[i].memory().offset;
+            try {
+                ops[i]->copy(_data + offset, other._data + offset);
+            } catch (...) {
+                _destroy_values(*other._shape, i);
+                throw;
+            }
+        }
+
+        _shape = other._shape;
+        return *this;
+    }
+
+    dynamic_object& operator=(dynamic_object&& other) noexcept {
+        if (this == &other) { return *this; }
+        _clear();
+
+        if (!other._is_inlined()) {
+            _release_heap();
+            _data = other._data, _capacity = other._capacity;
+            other._data = other._inline, other._capacity = inline_capacity;
+        } else {
+            _reserve(other._shape->size());
+            _move_values(*other._shape, other._data, _data);
+        }
+
+        _shape = std::exchange(other._shape, &dynamic_shape::root());
+        return *this;
+    }
+
+    ~dynamic_object() { _clear(), _release_heap(); }
+
+public:
+    object_traits const& traits() const override { return *_shape; }
+    dynamic_shape const& shape() const { return *_shape; }
+
+    /**
+     * Adds value-initialized property of given type. Returns existing one if there's already
+     *property of same tag, which throws property_type_mismatch_exception if the type differs.
+     */
+    template <typename Ty_>
+    Ty_& add(u8str_view tag) {
+        if (auto p = find<Ty_>(tag)) { return *p; }
+
+        auto& next = _shape->with<Ty_>(tag);
+        auto& m    = next.props().back().memory();
+
+        if (next.size() > _capacity) {
+            auto buf = _allocate(std::max(next.size(), _capacity * 2));
+            _move_values(*_shape, _data, buf.get());
+            _release_heap();
+            _data = buf.release(), _capacity = std::max(next.size(), _capacity * 2);
+        }
+
+        new (_data + m.offset) Ty_{};
+        _shape = &next;
+        return *reinterpret_cast<Ty_*>(_data + m.offset);
+    }
+
+    /** Adds property of which type is deduced in same way as CPPMARKUP_ELEMENT, then assigns value. */
+    template <typename Ty_>
+    auto& add(u8str_view tag, Ty_&& value) {
+        using value_type = decltype(etype::deduce(std::forward<Ty_>(value)));
+        return add<value_type>(tag) = etype::deduce(std::forward<Ty_>(value));
+    }
+
+    /** Returns nullptr if there's no such property. */
+    template <typename Ty_>
+    Ty_* find(u8str_view tag) {
+        auto prop = _shape->find_property(tag);
+        if (prop == nullptr) { return nullptr; }
+
+        property_type_mismatch_exception::verify<Ty_>(prop->memory());
+        if (prop->memory().size != sizeof(Ty_)) { throw property_type_mismatch_exception{"Extent mismatch"}; }
+        return reinterpret_cast<Ty_*>(_data + prop->memory().offset);
+    }
+
+    template <typename Ty_>
+    Ty_ const* find(u8str_view tag) const { return const_cast<dynamic_object*>(this)->find<Ty_>(tag); }
+
+    template <typename Ty_>
+    Ty_& at(u8str_view tag) {
+        if (auto p = find<Ty_>(tag)) { return *p; }
+        throw std::out_of_range{u8str(tag)};
+    }
+
+    template <typename Ty_>
+    Ty_ const& at(u8str_view tag) const { return const_cast<dynamic_object*>(this)->at<Ty_>(tag); }
+
+protected:
+    void* _base() override { return _data; }
+    void const* _base() const override { return _data; }
+
+private:
+    friend class dynamic_shape;
+
+    /** Replaces every property with value-initialized properties of given shape. Buffer is reused. */
+    void _reshape(dynamic_shape const& shape) {
+        _clear(), _reserve(shape.size());
+
+        for (size_t i = 0; i < shape._ops.size(); ++i) {
+            try {
+                shape._ops[i]->construct(_data + shape.props()[i].memory().offset);
+            } catch (...) {
+                _destroy_values(shape, i);
+                throw;
+            }
+        }
+
+        _shape = &shape;
+    }
+
+    void _clear() noexcept {
+        _destroy_values(*_shape, _shape->_ops.size());
+        _shape = &dynamic_shape::root();
+    }
+
+    void _destroy_values(dynamic_shape const& shape, size_t count) noexcept {
+        for (size_t i = 0; i < count; ++i) { shape._ops[i]->destroy(_data + shape.props()[i].memory().offset); }
+    }
+
+    static void _move_values(dynamic_shape const& shape, std::byte* from, std::byte* to) noexcept {
+        for (size_t i = 0; i < shape._ops.size(); ++i) {
+            auto offset = shape.props()[i].memory().offset;
+            shape._ops[i]->move(to + offset, from + offset);
+            shape._ops[i]->destroy(from + offset);
+        }
+    }
+
+    /** Ensures capacity of empty buffer */
+    void _reserve(size_t n) {
+        if (n <= _capacity) { return; }
+        auto buf = _allocate(n);
+        _release_heap();
+        _data = buf.release(), _capacity = n;
+    }
+
+    struct _heap_deleter {
+        void operator()(std::byte* p) const noexcept { ::operator delete(p); }
+    };
+
+    static std::unique_ptr<std::byte, _heap_deleter> _allocate(size_t n) {
+        return std::unique_ptr<std::byte, _heap_deleter>{static_cast<std::byte*>(::operator new(n))};
+    }
+
+    void _release_heap() noexcept {
+        if (!_is_inlined()) { ::operator delete(_data); }
+        _data = _inline, _capacity = inline_capacity;
+    }
+
+    bool _is_inlined() const noexcept { return _data == _inline; }
+
+private:
+    dynamic_shape const* _shape = &dynamic_shape::root();
+    std::byte* _data            = _inline;
+    size_t _capacity            = inline_capacity;
+
+    alignas(std::max_align_t) std::byte _inline[inline_capacity];
+};
+
+inline std::unique_ptr<object> dynamic_shape::create_empty_object() {
+    return std::make_unique<dynamic_object>(*this);
+}
+
+inline pooled_object dynamic_shape::acquire_object() const {
+    pooled_object o{object_pool<dynamic_object>::pop()};
+    if (!o) { o.reset(new dynamic_object); }
+
+    static_cast<dynamic_object&>(*o)._reshape(*this);
+    return o;
+}
+
+inline void dynamic_shape::release_object(object* p) const noexcept {
+    // values are dropped on release, but the buffer is kept for next use.
+    auto o = static_cast<dynamic_object*>(p);
+    o->_clear();
+    if (!object_pool<dynamic_object>::push(o)) { delete o; }
+}
 
 } // namespace kangsw::refl
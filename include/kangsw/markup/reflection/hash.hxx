@@ -0,0 +1,197 @@
+#pragma once
+#include <cstring>
+#include <limits>
+#include "property_proxy.hxx"
+
+namespace kangsw::refl {
+
+/**
+ * Streaming 64-bit hasher, which consumes input 8 bytes at a time.
+ *
+ * Mixing function is based on MurmurHash3; it is not cryptographic.
+ */
+class hasher {
+public:
+    explicit hasher(uint64_t seed = 0) noexcept : _h(seed ^ 0x9e3779b97f4a7c15ull) {}
+
+    void update(void const* data, size_t n) noexcept {
+        auto p = static_cast<char const*>(data);
+        _len += n;
+
+        // fill pending bytes first
+        if (_num_pending) {
+            auto const fill = std::min(n, sizeof _pending - _num_pending);
+            memcpy(reinterpret_cast<char*>(&_pending) + _num_pending, p, fill);
+            p += fill, n -= fill, _num_pending += fill;
+
+            if (_num_pending < sizeof _pending) { return; }
+            _consume(_pending), _num_pending = 0;
+        }
+
+        for (; n >= sizeof(uint64_t); p += sizeof(uint64_t), n -= sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, p, sizeof word);
+            _consume(word);
+        }
+
+        if (n) { _pending = 0, memcpy(&_pending, p, n), _num_pending = n; }
+    }
+
+    template <typename Ty_>
+    void update_value(Ty_ const& v) noexcept {
+        static_assert(std::is_trivially_copyable_v<Ty_>);
+        update(&v, sizeof v);
+    }
+
+    uint64_t digest() const noexcept {
+        auto h = _h;
+        if (_num_pending) {
+            uint64_t tail = 0;
+            memcpy(&tail, &_pending, _num_pending);
+            h ^= _scramble(tail);
+        }
+        return _fmix(h ^ _len);
+    }
+
+private:
+    static uint64_t _rotate_left(uint64_t x, int r) noexcept { return (x << r) | (x >> (64 - r)); }
+
+    static uint64_t _scramble(uint64_t k) noexcept {
+        k *= 0x87c37b91114253d5ull, k = _rotate_left(k, 31), k *= 0x4cf5ad432745937full;
+        return k;
+    }
+
+    static uint64_t _fmix(uint64_t k) noexcept {
+        k ^= k >> 33, k *= 0xff51afd7ed558ccdull;
+        k ^= k >> 33, k *= 0xc4ceb9fe1a85ec53ull;
+        return k ^ (k >> 33);
+    }
+
+    void _consume(uint64_t word) noexcept {
+        _h ^= _scramble(word);
+        _h = _rotate_left(_h, 27) * 5 + 0x52dce729;
+    }
+
+private:
+    uint64_t _h;
+    uint64_t _len       = 0;
+    uint64_t _pending   = 0;
+    size_t _num_pending = 0;
+};
+
+namespace _internal {
+inline void _hash(hasher& h, object const& v);
+
+/**
+ * Maps floating point values which \ref equal treats as same, i.e. -0.0 and 0.0 or NaNs of any
+ *payload, onto single representation.
+ */
+template <typename Ty_>
+Ty_ _canonical(Ty_ v) noexcept {
+    if constexpr (std::is_floating_point_v<Ty_>) {
+        if (v == Ty_{}) { return Ty_{}; }
+        if (v != v) { return std::numeric_limits<Ty_>::quiet_NaN(); }
+    }
+    return v;
+}
+
+template <typename Ty_>
+void _hash(hasher& h, Ty_ const& v) {
+    constexpr auto T = etype::from_type<Ty_>();
+
+    if constexpr (T.is_null()) {
+        // null doesn't carry any value.
+    } else if constexpr (T.is_boolean()) {
+        h.update_value(bool(v));
+    } else if constexpr (T.is_number()) {
+        h.update_value(_canonical(v));
+    } else if constexpr (T.is_timestamp()) {
+        h.update_value(v.time_since_epoch().count());
+    } else if constexpr (T.is_string() || T.is_binary()) {
+        h.update_value(v.size()), h.update(v.data(), v.size());
+    } else if constexpr (T.is_array()) {
+        h.update_value(v.size());
+        for (auto&& elem : v) { _hash(h, elem); }
+    } else {
+        static_assert(false, "unsupported type");
+    }
+}
+
+/**
+ * Hashes contiguous range of elements. Integers are fed as raw bytes at once, and floating point
+ *numbers are canonicalized into small batches before being fed.
+ */
+template <typename Ty_>
+void _hash_range(hasher& h, Ty_ const* data, size_t n) {
+    h.update_value(n);
+    if constexpr (std::is_integral_v<Ty_>) {
+        h.update(data, n * sizeof(Ty_));
+    } else if constexpr (std::is_floating_point_v<Ty_>) {
+        Ty_ batch[64];
+        for (size_t i = 0; i < n;) {
+            size_t k = 0;
+            for (; k < std::size(batch) && i < n; ++k, ++i) { batch[k] = _canonical(data[i]); }
+            h.update(batch, k * sizeof(Ty_));
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) { _hash(h, data[i]); }
+    }
+}
+
+template <typename Ty_>
+void _hash(hasher& h, property_proxy<Ty_, true> p) {
+    constexpr auto T = etype::from_type<Ty_>();
+
+    if constexpr (!T.is_container()) {
+        _hash(h, *p);
+    } else if constexpr (templates::is_specialization_of<Ty_, std::vector>::value && !T.is_object()) {
+        _hash_range(h, p->data(), p->size());
+    } else if constexpr (templates::is_specialization_of<Ty_, small_vector_base>::value) {
+        _hash_range(h, p->data(), p->size());
+    } else if constexpr (templates::is_specialization_of<Ty_, fixed_array_t>::value) {
+        _hash_range(h, p.begin(), p.size());
+    } else if constexpr (std::is_same_v<Ty_, bit_vector>) {
+        h.update_value(p->size());
+        h.update(p->words().data(), p->words().size() * sizeof(bit_vector::word_type));
+    } else if constexpr (templates::is_specialization_of<Ty_, nested_vector>::value) {
+        _hash_range(h, p->offsets().data(), p->offsets().size());
+        _hash_range(h, p->values().data(), p->values().size());
+    } else if constexpr (T.is_array()) { // object array
+        h.update_value(p.size());
+        for (size_t i = 0, n = p.size(); i < n; ++i) { _hash(h, p[i]); }
+    } else { // map
+        h.update_value(p.size());
+        p.for_each([&h](u8str_view key, auto const& value) {
+            h.update_value(key.size()), h.update(key.data(), key.size());
+            _hash(h, value);
+        });
+    }
+}
+
+inline void _hash(hasher& h, object const& v) {
+    auto const base = v.base();
+    h.update_value(v.properties().size());
+
+    for (auto& prop : v.properties()) {
+        visit_property(base, prop, [&h](auto proxy) { _hash(h, proxy); });
+        for (auto& attr : prop.attributes()) {
+            visit_property(base, attr, [&h](auto proxy) { _hash(h, *proxy); });
+        }
+    }
+}
+} // namespace _internal
+
+/**
+ * Computes 64-bit hash from content of object, without serializing it.
+ *
+ * Objects which \ref equal considers same always hash equally; thus -0.0 and 0.0, or NaNs of
+ *different payloads, are hashed as single value. Objects of different types may collide if they
+ *share same memory representation.
+ */
+inline uint64_t hash(object const& obj, uint64_t seed = 0) {
+    hasher h{seed};
+    _internal::_hash(h, obj);
+    return h.digest();
+}
+
+} // namespace kangsw::refl
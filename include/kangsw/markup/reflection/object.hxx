@@ -1,5 +1,6 @@
 #pragma once
 #include "object_traits.hxx"
+#include "object_state.hxx"
 
 namespace kangsw::refl {
 
@@ -31,6 +32,13 @@ protected:
 public:
     void reset();
 
+    /** Gets change tracking block, if the object opted in. */
+    object_state* state() const {
+        auto const offset = traits().state_offset();
+        if (offset < 0) { return nullptr; }
+        return reinterpret_cast<object_state*>(const_cast<char*>(static_cast<char const*>(_base())) + offset);
+    }
+
 public:
     void* operator[](property const& p) { return p.memory()(_base()); }
     void const* operator[](property const& p) const { return p.memory()(_base()); }
@@ -46,6 +54,12 @@ inline void object::reset() {
             attr._memory.init_fn((*this)[attr]);
         }
     }
+
+    if (auto s = state()) { s->invalidate(), s->discard_deferred(); }
+}
+
+inline void object_recycler::operator()(object* p) const noexcept {
+    if (p) { p->traits().release_object(p); }
 }
 
 } // namespace kangsw::refl
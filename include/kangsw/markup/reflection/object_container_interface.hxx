@@ -14,7 +14,7 @@ public:
 
     virtual object& push_back(void* p) const                  = 0;
     virtual void erase(void* p, size_t from, size_t to) const = 0;
-    virtual void reserve(void* p, size_t new_size)            = 0;
+    virtual void reserve(void* p, size_t new_size) const      = 0;
 };
 
 /** Object container support - map */
@@ -30,6 +30,7 @@ public:
 
     virtual object& insert(void* p, u8str_view s) const = 0;
     virtual void erase(void* p, u8str_view s) const     = 0;
+    virtual void clear(void* p) const                   = 0;
 
     virtual void for_each(void* p, std::function<void(u8str_view, object&)> const&) const             = 0;
     virtual void for_each(void const* p, std::function<void(u8str_view, object const&)> const&) const = 0;
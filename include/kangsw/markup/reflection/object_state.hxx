@@ -0,0 +1,177 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "kangsw/markup/types.hxx"
+
+namespace kangsw::refl {
+class property;
+
+struct deferred_parse_exception : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * Optional bookkeeping block of an object, which tracks modified properties.
+ *
+ * Dirty bits are set whenever a property is accessed through mutable accessors of non-const
+ *\ref property_proxy, which includes every write performed by parsers. Direct member writes
+ *bypass reflection, thus should be followed by \ref mark_dirty manually.
+ *
+ * Also holds serialized fragment of each property, which is dropped on modification, and raw
+ *serialized value of each property of which parsing was deferred until first access. Fragment
+ *of whole object is validated by signature, which covers versions of every object it contains.
+ *
+ * Fragments may be read and stored by concurrent serializers of same object; any modification
+ *must not run concurrently with them, as modification of object members must not.
+ */
+class object_state {
+public:
+    /** Index of fragment which covers whole object, including objects it contains. */
+    static constexpr size_t whole = ~size_t{};
+
+public:
+    /** Marks property of given index as modified, and drops its cached fragment. */
+    void mark_dirty(size_t index) {
+        if (index >= _dirty.size()) { _dirty.resize(index + 1); }
+        _dirty[index] = true;
+        _version      = 0;
+
+        if (index < _fragments.size()) { _fragments[index].text.clear(); }
+    }
+
+    bool is_dirty(size_t index) const { return index < _dirty.size() && _dirty[index]; }
+    bool any_dirty() const { return _dirty.any(); }
+    auto& dirty_bits() const { return _dirty; }
+
+    /** Clears dirty bits; i.e. after publishing changes. Cached fragments are kept. */
+    void clear_dirty() { _dirty.reset(); }
+
+    /** Drops every cached fragment */
+    void invalidate() { _fragments.clear(), _whole = {}, _version = 0; }
+
+    /**
+     * Identifies content of this object; it changes on every modification, and is never shared
+     *with other objects unless they were copied from this one without modification since.
+     */
+    uint64_t version() const {
+        std::lock_guard _{_lock};
+        if (_version == 0) { _version = ++_last_version; }
+        return _version;
+    }
+
+public:
+    /**
+     * Appends cached fragment of property, which was serialized in given format with given
+     *signature, to out. Returns false if there's no valid fragment.
+     */
+    bool append_fragment(size_t index, int64_t format_key, uint64_t signature, u8str& out) const {
+        std::lock_guard _{_lock};
+        if (format_key != _format_key) { return false; }
+
+        auto fragment = index == whole ? &_whole : index < _fragments.size() ? &_fragments[index] : nullptr;
+        if (fragment == nullptr || fragment->text.empty() || fragment->signature != signature) { return false; }
+        return out.append(fragment->text), true;
+    }
+
+    /** Stores serialized fragment. Fragments of any other format are dropped. */
+    void store_fragment(size_t index, int64_t format_key, u8str_view fragment, uint64_t signature = 0) const {
+        std::lock_guard _{_lock};
+        if (format_key != _format_key) { _fragments.clear(), _whole = {}, _format_key = format_key; }
+        if (index != whole && index >= _fragments.size()) { _fragments.resize(index + 1); }
+
+        auto& dest = index == whole ? _whole : _fragments[index];
+        dest.text.assign(fragment.begin(), fragment.end()), dest.signature = signature;
+    }
+
+public:
+    /** Parses raw value into property, which is located at base. Returns false if value is malformed. */
+    using materializer_t = bool (*)(object_baseaddr_t* base, property const& prop, u8str_view raw);
+
+    /**
+     * Defers parsing of property until it is accessed through reflection; see \ref materialize.
+     * Direct member access bypasses deferred values, as it bypasses dirty tracking.
+     *
+     * Encoding key is opaque to the state; it identifies encodings which raw value was written
+     *in, thus serializers can tell whether raw value can be forwarded as is.
+     */
+    void defer(size_t index, u8str_view raw, materializer_t fn, int64_t encoding_key = 0) {
+        if (index >= _deferred.size()) { _deferred.resize(index + 1); }
+        _version = 0;
+        if (_deferred[index].raw.empty()) { ++_num_deferred; }
+        _deferred[index].raw.assign(raw.begin(), raw.end());
+        _deferred[index].fn           = fn;
+        _deferred[index].encoding_key = encoding_key;
+    }
+
+    /** Retrieves raw value of property which is not parsed yet. Returns nullptr if there's none. */
+    u8str const* deferred(size_t index) const {
+        if (_num_deferred == 0 || index >= _deferred.size() || _deferred[index].raw.empty()) { return nullptr; }
+        return &_deferred[index].raw;
+    }
+
+    /** Encoding key which deferred value of property was given with. */
+    int64_t deferred_encoding(size_t index) const { return index < _deferred.size() ? _deferred[index].encoding_key : 0; }
+
+    bool any_deferred() const { return _num_deferred > 0; }
+
+    /** Parses deferred value of property, if any. Reading a property doesn't make it dirty. */
+    void materialize(object_baseaddr_t* base, size_t index, property const& prop) {
+        if (deferred(index) == nullptr) { return; }
+
+        // slot is emptied first, since parsing accesses the property again.
+        auto raw = std::move(_deferred[index].raw);
+        auto fn  = _deferred[index].fn;
+        _deferred[index].raw.clear(), --_num_deferred;
+
+        bool const was_dirty = is_dirty(index);
+        if (!fn(base, prop, raw)) { throw deferred_parse_exception{std::move(raw)}; }
+        if (!was_dirty && index < _dirty.size()) { _dirty[index] = false; }
+    }
+
+    /** Drops every deferred value without parsing; i.e. on reset. */
+    void discard_deferred() { _deferred.clear(), _num_deferred = 0, _version = 0; }
+
+private:
+    struct _fragment {
+        u8str text;
+        uint64_t signature = 0;
+    };
+
+    /** Lock which is never copied along with the state; fragments are rarely contended. */
+    struct _spin_lock {
+        _spin_lock() = default;
+        _spin_lock(_spin_lock const&) noexcept {}
+        _spin_lock& operator=(_spin_lock const&) noexcept { return *this; }
+
+        void lock() noexcept {
+            while (_flag.test_and_set(std::memory_order_acquire)) { std::this_thread::yield(); }
+        }
+        void unlock() noexcept { _flag.clear(std::memory_order_release); }
+
+        std::atomic_flag _flag = ATOMIC_FLAG_INIT;
+    };
+
+    struct _deferred_value {
+        u8str raw;
+        materializer_t fn    = nullptr;
+        int64_t encoding_key = 0;
+    };
+
+private:
+    bit_vector _dirty;
+    mutable std::vector<_fragment> _fragments;
+    mutable _fragment _whole;
+    mutable int64_t _format_key = -1;
+    mutable uint64_t _version   = 0; // 0 if modified since last query
+    mutable _spin_lock _lock;
+
+    static inline std::atomic<uint64_t> _last_version{0};
+
+    std::vector<_deferred_value> _deferred;
+    size_t _num_deferred = 0;
+};
+
+} // namespace kangsw::refl
@@ -6,13 +6,32 @@
 
 namespace kangsw::refl {
 
+/** Deleter of pooled objects, which returns the instance to pool of its traits. */
+struct object_recycler {
+    void operator()(object* p) const noexcept;
+};
+
+using pooled_object = std::unique_ptr<object, object_recycler>;
+
 class object_traits {
 public:
     virtual ~object_traits() = default;
     auto& props() const { return _props; }
 
+    /** Stable name of the type. Nested types are qualified with name of enclosing type, i.e. "outer::inner" */
+    virtual u8str_view name() const = 0;
+
     virtual std::unique_ptr<object> create_empty_object() = 0;
 
+    /**
+     * Acquires object from pool of calling thread, or allocates new one if the pool is empty.
+     * Acquired object always holds default values, and is recycled on destruction.
+     */
+    virtual pooled_object acquire_object() const = 0;
+
+    /** Resets object, then returns it to pool. Invoked by \ref object_recycler */
+    virtual void release_object(object* p) const noexcept = 0;
+
 public:
     /** Add new or find existing property. */
     property& find_or_add_property(u8str_view tag) {
@@ -53,9 +72,16 @@ public:
 
     // .remove_property
 
+    /** Offset of \ref object_state block from object base address. Negative if not tracked. */
+    ptrdiff_t state_offset() const { return _state_offset; }
+
+    // for internal usage
+    void _set_state_offset(ptrdiff_t offset) { _state_offset = offset; }
+
 private:
     std::vector<property> _props;
     std::vector<std::pair<u8str, size_t>> _index;
+    ptrdiff_t _state_offset = -1;
 };
 
 } // namespace kangsw::refl
@@ -9,7 +9,21 @@ namespace kangsw::refl {
 /** */
 namespace property_flag {
 enum type : uint64_t {
-    none
+    none = 0,
+
+    // timestamp encoding of property, which overrides one of marshaling call
+    timestamp_iso8601       = 1,
+    timestamp_epoch_ms      = 2,
+    timestamp_epoch_us      = 3,
+    timestamp_epoch_ns      = 4,
+    timestamp_encoding_mask = 0x7,
+
+    // binary encoding of property, which overrides one of marshaling call
+    binary_base64        = 1 << 3,
+    binary_hex           = 2 << 3,
+    binary_base85        = 3 << 3,
+    binary_sidecar       = 4 << 3,
+    binary_encoding_mask = 0x7 << 3,
 };
 }
 
@@ -34,12 +48,22 @@ public:
         /** */
         etype type;
 
+        /** actual storage width of numeric types */
+        esubtype subtype;
+
+        /** storage layout of array types */
+        elayout layout;
+
         /** */
         size_t offset;
 
         /** */
         size_t size;
 
+        /** traits which owns this property, and index of the property in it */
+        object_traits const* owner;
+        size_t index;
+
         /** initializes memory represented by this property */
         std::function<void(void*)> init_fn;
 
@@ -66,12 +90,14 @@ public:
     auto& attributes() const { return _attr; }
     auto& tag() const { return _tag; }
     auto& doc() const { return _doc; }
+    auto flags() const { return _flag; }
     auto& memory() const { return _memory; }
     auto& type() const { return _memory.type; }
 
     auto ovi() const { return _ovi.get(); }
     auto omi() const { return _omi.get(); }
 
+    /** Traits of object type which this property holds. Valid only for object properties. */
     object_traits const& get_object_traits() const { return *_traits_if_exist; }
 
 public:
@@ -0,0 +1,196 @@
+#pragma once
+#include <charconv>
+#include <stdexcept>
+#include "property_proxy.hxx"
+
+namespace kangsw::refl {
+
+struct invalid_property_path_exception : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+namespace _internal {
+/** Splits JSON pointer into unescaped reference tokens. */
+inline std::vector<u8str> split_json_pointer(u8str_view pointer) {
+    if (pointer.empty() || pointer[0] != '/') {
+        throw invalid_property_path_exception{"path must start with '/'"};
+    }
+
+    std::vector<u8str> tokens;
+    for (size_t pos = 1;;) {
+        auto const next  = std::min(pointer.find('/', pos), pointer.size());
+        auto const token = pointer.substr(pos, next - pos);
+
+        auto& r = tokens.emplace_back();
+        for (size_t i = 0; i < token.size(); ++i) {
+            if (token[i] == '~' && i + 1 < token.size() && (token[i + 1] == '0' || token[i + 1] == '1')) {
+                r.push_back(token[++i] == '0' ? '~' : '/');
+            } else {
+                r.push_back(token[i]);
+            }
+        }
+
+        if (next == pointer.size()) { break; }
+        pos = next + 1;
+    }
+    return tokens;
+}
+} // namespace _internal
+
+/**
+ * Accessor of deeply nested property, which is compiled from JSON pointer(RFC 6901) once.
+ *
+ * Path addresses JSON representation of object; i.e. "/some_obj_map/entity/single_elem"
+ *visits property single_elem of map entry "entity", and "/arr/0/elem~0@@ATTR@@/attr" visits
+ *attribute of elem of the first element of arr. Path must end at a property or an attribute.
+ *
+ * Compiled path holds only property descriptors, array indices and map keys, thus resolving
+ *never compares strings except for map keys. It is bound to the traits which compiled it.
+ */
+class property_path {
+    struct _step {
+        property const* prop;
+        size_t index; // for object arrays
+        u8str key;    // for object maps
+    };
+
+public:
+    property_path(object_traits const& traits, u8str_view pointer) : _traits(&traits) {
+        auto const tokens = _internal::split_json_pointer(pointer);
+
+        auto current = &traits;
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            u8str_view token = tokens[i];
+            bool const is_attr_block = token.size() > ATTR_SUFFIX.size()
+                                       && token.substr(token.size() - ATTR_SUFFIX.size()) == ATTR_SUFFIX;
+            if (is_attr_block) { token.remove_suffix(ATTR_SUFFIX.size()); }
+
+            auto prop = current->find_property(token);
+            if (prop == nullptr) { throw invalid_property_path_exception{"property not found: " + u8str(token)}; }
+
+            if (is_attr_block) {
+                if (i + 2 != tokens.size()) { throw invalid_property_path_exception{"attribute must be the last token"}; }
+
+                auto& attrs = prop->attributes();
+                auto it     = std::find_if(attrs.begin(), attrs.end(), [&](auto& a) { return a.name == tokens[i + 1]; });
+                if (it == attrs.end()) { throw invalid_property_path_exception{"attribute not found: " + tokens[i + 1]}; }
+
+                _target = prop, _target_attr = &*it;
+                return;
+            }
+
+            if (i + 1 == tokens.size()) {
+                _target = prop;
+                return;
+            }
+
+            auto const type = prop->type();
+            if (!type.is_object()) { throw invalid_property_path_exception{"not an object: " + u8str(token)}; }
+
+            if (type.is_array()) {
+                size_t index = 0;
+                auto& s      = tokens[++i];
+                auto r       = std::from_chars(s.data(), s.data() + s.size(), index);
+                if (s.empty() || r.ec != std::errc{} || r.ptr != s.data() + s.size()) {
+                    throw invalid_property_path_exception{"invalid array index: " + s};
+                }
+                _steps.push_back({prop, index, {}});
+            } else if (type.is_map()) {
+                _steps.push_back({prop, 0, tokens[++i]});
+            } else {
+                _steps.push_back({prop, 0, {}});
+            }
+
+            current = &prop->get_object_traits();
+        }
+
+        // path ended with container step, which doesn't designate any property.
+        throw invalid_property_path_exception{"path must end at a property or an attribute"};
+    }
+
+public:
+    /** Type of target property or attribute */
+    etype type() const { return _target_memory().type; }
+    property const& target_property() const { return *_target; }
+    property::attribute const* target_attribute() const { return _target_attr; }
+
+    /** Finds owner object of target. Returns nullptr if an array element or a map entry on the way doesn't exist. */
+    object* owner(object& obj) const { return _owner<object>(obj); }
+    object const* owner(object const& obj) const { return _owner<object const>(obj); }
+
+    /**
+     * Retrieves pointer to target, of which type is verified. Returns nullptr if target doesn't exist.
+     * Non-const access marks target modified, as non-const \ref property_proxy does.
+     */
+    template <typename Ty_>
+    Ty_* find(object& obj) const {
+        property_type_mismatch_exception::verify<Ty_>(_target_memory());
+        auto o = owner(obj);
+        if (o == nullptr) { return nullptr; }
+
+        materialize(o->base(), *_target), mark_dirty(o->base(), _target->memory());
+        return static_cast<Ty_*>(_target_memory()(o->base()));
+    }
+
+    template <typename Ty_>
+    Ty_ const* find(object const& obj) const {
+        property_type_mismatch_exception::verify<Ty_>(_target_memory());
+        auto o = owner(obj);
+        if (o == nullptr) { return nullptr; }
+
+        materialize(o->base(), *_target);
+        return static_cast<Ty_ const*>(_target_memory()(o->base()));
+    }
+
+    /** Invokes fn with proxy of target, as \ref visit_property does. Returns false if target doesn't exist. */
+    template <typename Obj_, typename Fn_>
+    bool visit(Obj_& obj, Fn_&& fn) const {
+        auto o = owner(obj);
+        if (o == nullptr) { return false; }
+
+        if (_target_attr) {
+            visit_property(o->base(), *_target_attr, std::forward<Fn_>(fn));
+        } else {
+            visit_property(o->base(), *_target, std::forward<Fn_>(fn));
+        }
+        return true;
+    }
+
+private:
+    property::memory_t const& _target_memory() const {
+        return _target_attr ? _target_attr->memory() : _target->memory();
+    }
+
+    template <typename Obj_>
+    Obj_* _owner(Obj_& obj) const {
+        if (&obj.traits() != _traits) { throw std::invalid_argument{"path was compiled for other type"}; }
+
+        // each step parses deferred value of its property before reading it, as proxies do.
+        auto o = &obj;
+        for (auto& step : _steps) {
+            materialize(o->base(), *step.prop);
+            auto p    = step.prop->memory()(o->base());
+            auto type = step.prop->type();
+
+            if (type.is_array()) {
+                auto ovi = step.prop->ovi();
+                if (step.index >= ovi->size(p)) { return nullptr; }
+                o = &ovi->at(p, step.index);
+            } else if (type.is_map()) {
+                if ((o = step.prop->omi()->find(p, step.key)) == nullptr) { return nullptr; }
+            } else {
+                o = static_cast<Obj_*>(p);
+            }
+        }
+
+        return o;
+    }
+
+private:
+    object_traits const* _traits;
+    std::vector<_step> _steps;
+    property const* _target                 = nullptr;
+    property::attribute const* _target_attr = nullptr;
+};
+
+} // namespace kangsw::refl
@@ -16,7 +16,9 @@ public:
 
     template <typename Ty_>
     static void verify(property::memory_t const& m) {
-        if (m.type != etype::from_type_exact<Ty_>()) {
+        if (m.type != etype::from_type_exact<Ty_>()
+            || m.subtype != etype::subtype_from_type<Ty_>()
+            || m.layout != etype::layout_from_type<Ty_>()) {
             auto exception     = property_type_mismatch_exception{"Type mismatch"};
             exception.expected = etype::from_type_exact<Ty_>();
             exception.actual   = m.type;
@@ -29,13 +31,40 @@ public:
     etype actual;
 };
 
+namespace _internal {
+/**
+ * Marks owner property of non-const proxy dirty on each access which can modify it; accessors
+ *which can't, i.e. size() or const overloads, leave it clean.
+ */
+template <bool Constant_>
+class _proxy_tracker {
+public:
+    void _track(object_state* state, size_t index) { _state = state, _index = index; }
+
+protected:
+    void _touch() const {
+        if (_state) { _state->mark_dirty(_index); }
+    }
+
+private:
+    object_state* _state = nullptr;
+    size_t _index        = 0;
+};
+
+template <>
+class _proxy_tracker<true> {
+protected:
+    void _touch() const {}
+};
+} // namespace _internal
+
 /**
  * Generic property proxy type to manipulate trivial types.
  *
  * Single class can handle both of const and non-const instance of original reference.
  */
 template <typename Ty_, bool Constant_>
-class property_proxy {
+class property_proxy : public _internal::_proxy_tracker<Constant_> {
 public:
     using void_pointer = std::conditional_t<Constant_, void const*, void*>;
     using src_type     = std::conditional_t<Constant_, Ty_ const, Ty_>;
@@ -55,8 +84,8 @@ public:
     constexpr auto type() { return etype::from_type<Ty_>(); }
 
 public:
-    reference operator*() const { return *_p; }
-    pointer operator->() const { return _p; }
+    reference operator*() const { return this->_touch(), *_p; }
+    pointer operator->() const { return this->_touch(), _p; }
 
 private:
     pointer _p;
@@ -68,7 +97,7 @@ private:
  * Which wraps several vector operations into few common APIs which can be shared with object_vector_interface.
  */
 template <typename ValueTy_, bool Constant_>
-class property_proxy<std::vector<ValueTy_>, Constant_> {
+class property_proxy<std::vector<ValueTy_>, Constant_> : public _internal::_proxy_tracker<Constant_> {
 public:
     using Ty_ = std::vector<ValueTy_>;
 
@@ -89,16 +118,196 @@ public:
 
     auto size() const { return _p->size(); }
     auto empty() const { return _p->empty(); }
-    auto& emplace_back() { return _p->emplace_back(); }
+    auto& emplace_back() { return this->_touch(), _p->emplace_back(); }
+
+    auto& operator[](size_t i) { return this->_touch(), _p->operator[](i); }
+    auto& operator[](size_t i) const { return static_cast<Ty_ const*>(_p)->operator[](i); }
+
+    void reserve(size_t c) { this->_touch(), _p->reserve(c); }
+
+    void erase(size_t from, size_t to) { this->_touch(), _p->erase(_p->begin() + from, _p->begin() + to); }
+    void erase(size_t at) { erase(at, at + 1); }
+
+    reference operator*() const { return this->_touch(), *_p; }
+    pointer operator->() const { return this->_touch(), _p; }
+
+    constexpr auto type() { return etype::from_type<Ty_>(); }
+
+private:
+    pointer _p;
+};
+
+/**
+ * Bit-packed boolean array specialization of property_proxy.
+ *
+ * Shares common array APIs with vector specialization, except subscript yields value instead of
+ *reference. Underlying bit_vector is exposed via dereference, for bit writes and word-level operations.
+ */
+template <bool Constant_>
+class property_proxy<bit_vector, Constant_> : public _internal::_proxy_tracker<Constant_> {
+public:
+    using Ty_ = bit_vector;
+
+    using void_pointer = std::conditional_t<Constant_, void const*, void*>;
+    using src_type     = std::conditional_t<Constant_, Ty_ const, Ty_>;
+    using pointer      = src_type*;
+    using reference    = src_type&;
+
+    using value_type = typename Ty_::value_type;
+
+public:
+    property_proxy(property const& m, void_pointer ptr) : _p(static_cast<pointer>(ptr)) {
+        property_type_mismatch_exception::verify<Ty_>(m.memory());
+    }
+
+    template <bool OtherConstant_>
+    property_proxy(property_proxy<Ty_, OtherConstant_> other) : _p(other._p) {}
+
+    auto size() const { return _p->size(); }
+    auto empty() const { return _p->empty(); }
+    auto emplace_back() { return this->_touch(), _p->emplace_back(); }
+    void push_back(bool value) { this->_touch(), _p->push_back(value); }
+
+    value_type operator[](size_t i) const { return _p->test(i); }
+
+    void reserve(size_t c) { this->_touch(), _p->reserve(c); }
+
+    void erase(size_t from, size_t to) { this->_touch(), _p->erase(from, to); }
+    void erase(size_t at) { erase(at, at + 1); }
+
+    reference operator*() const { return this->_touch(), *_p; }
+    pointer operator->() const { return this->_touch(), _p; }
+
+    constexpr auto type() { return etype::from_type<Ty_>(); }
+
+private:
+    pointer _p;
+};
+
+/**
+ * Fixed array specialization of property_proxy, which wraps std::array of any extent.
+ *
+ * Extent is resolved from memory size of the property. As fixed array can't be resized, this
+ *only shares read/write APIs of array proxies.
+ */
+template <typename ValueTy_, bool Constant_>
+class property_proxy<fixed_array_t<ValueTy_>, Constant_> : public _internal::_proxy_tracker<Constant_> {
+public:
+    using Ty_ = fixed_array_t<ValueTy_>;
+
+    using void_pointer = std::conditional_t<Constant_, void const*, void*>;
+    using pointer      = std::conditional_t<Constant_, ValueTy_ const*, ValueTy_*>;
+
+    using value_type = ValueTy_;
+
+public:
+    property_proxy(property const& m, void_pointer ptr)
+      : _p(static_cast<pointer>(ptr)), _extent(m.memory().size / sizeof(ValueTy_)) {
+        property_type_mismatch_exception::verify<Ty_>(m.memory());
+    }
+
+    template <bool OtherConstant_>
+    property_proxy(property_proxy<Ty_, OtherConstant_> other) : _p(other._p), _extent(other._extent) {}
+
+    auto size() const { return _extent; }
+    auto empty() const { return _extent == 0; }
+
+    auto& operator[](size_t i) { return this->_touch(), _p[i]; }
+    auto& operator[](size_t i) const { return static_cast<ValueTy_ const*>(_p)[i]; }
+
+    auto begin() const { return this->_touch(), _p; }
+    auto end() const { return _p + _extent; }
+
+    constexpr auto type() { return etype::from_type<Ty_>(); }
+
+private:
+    pointer _p;
+    size_t _extent;
+};
+
+/**
+ * small_vector specialization of property_proxy. Works in same way with vector specialization.
+ */
+template <typename ValueTy_, bool Constant_>
+class property_proxy<small_vector_base<ValueTy_>, Constant_> : public _internal::_proxy_tracker<Constant_> {
+public:
+    using Ty_ = small_vector_base<ValueTy_>;
+
+    using void_pointer = std::conditional_t<Constant_, void const*, void*>;
+    using src_type     = std::conditional_t<Constant_, Ty_ const, Ty_>;
+    using pointer      = src_type*;
+    using reference    = src_type&;
+
+    using value_type = typename src_type::value_type;
+
+public:
+    property_proxy(property const& m, void_pointer ptr) : _p(static_cast<pointer>(ptr)) {
+        property_type_mismatch_exception::verify<Ty_>(m.memory());
+    }
+
+    template <bool OtherConstant_>
+    property_proxy(property_proxy<Ty_, OtherConstant_> other) : _p(other._p) {}
+
+    auto size() const { return _p->size(); }
+    auto empty() const { return _p->empty(); }
+    auto& emplace_back() { return this->_touch(), _p->emplace_back(); }
 
-    auto& operator[](size_t i) { return _p->operator[](i); }
+    auto& operator[](size_t i) { return this->_touch(), _p->operator[](i); }
     auto& operator[](size_t i) const { return static_cast<Ty_ const*>(_p)->operator[](i); }
 
-    void reserve(size_t c) { _p->reserve(c); }
+    void reserve(size_t c) { this->_touch(), _p->reserve(c); }
 
-    void erase(size_t from, size_t to) { _p->erase(_p->begin() + from, _p->begin() + to); }
+    void erase(size_t from, size_t to) { this->_touch(), _p->erase(_p->begin() + from, _p->begin() + to); }
     void erase(size_t at) { erase(at, at + 1); }
 
+    reference operator*() const { return this->_touch(), *_p; }
+    pointer operator->() const { return this->_touch(), _p; }
+
+    constexpr auto type() { return etype::from_type<Ty_>(); }
+
+private:
+    pointer _p;
+};
+
+/**
+ * nested_vector specialization of property_proxy. Each element is a row view.
+ */
+template <typename ValueTy_, bool Constant_>
+class property_proxy<nested_vector<ValueTy_>, Constant_> : public _internal::_proxy_tracker<Constant_> {
+public:
+    using Ty_ = nested_vector<ValueTy_>;
+
+    using void_pointer = std::conditional_t<Constant_, void const*, void*>;
+    using src_type     = std::conditional_t<Constant_, Ty_ const, Ty_>;
+    using pointer      = src_type*;
+    using reference    = src_type&;
+
+    using value_type = ValueTy_;
+
+public:
+    property_proxy(property const& m, void_pointer ptr) : _p(static_cast<pointer>(ptr)) {
+        property_type_mismatch_exception::verify<Ty_>(m.memory());
+    }
+
+    template <bool OtherConstant_>
+    property_proxy(property_proxy<Ty_, OtherConstant_> other) : _p(other._p) {}
+
+    /** Number of rows */
+    auto size() const { return _p->size(); }
+    auto empty() const { return _p->empty(); }
+
+    /** Appends new empty row, then returns it */
+    auto emplace_back() { return this->_touch(), _p->emplace_back(), _p->back(); }
+
+    auto operator[](size_t i) { return this->_touch(), _p->operator[](i); }
+    auto operator[](size_t i) const { return static_cast<Ty_ const*>(_p)->operator[](i); }
+
+    void erase(size_t from, size_t to) { this->_touch(), _p->erase(from, to); }
+    void erase(size_t at) { erase(at, at + 1); }
+
+    reference operator*() const { return this->_touch(), *_p; }
+    pointer operator->() const { return this->_touch(), _p; }
+
     constexpr auto type() { return etype::from_type<Ty_>(); }
 
 private:
@@ -110,7 +319,7 @@ private:
  * Wraps object_vector_interface
  */
 template <bool Constant_>
-class property_proxy<std::vector<object>, Constant_> {
+class property_proxy<std::vector<object>, Constant_> : public _internal::_proxy_tracker<Constant_> {
 public:
     using Vty_         = object;
     using Ty_          = std::vector<Vty_>;
@@ -129,15 +338,15 @@ public:
 
     auto size() const { return _if->size(_p); }
     auto empty() const { return size() == 0; }
-    auto& emplace_back() { return _if->push_back(_p); }
+    auto& emplace_back() { return this->_touch(), _if->push_back(_p); }
 
-    auto& operator[](size_t i) { return _if->at(_p, i); }
+    auto& operator[](size_t i) { return this->_touch(), _if->at(_p, i); }
     auto& operator[](size_t i) const { return _if->at(static_cast<void const*>(_p), i); }
 
-    void reserve(size_t c) { _if->reserve(_p, c); }
+    void reserve(size_t c) { this->_touch(), _if->reserve(_p, c); }
 
-    void erase(size_t from, size_t to) { _if->erase(_p, from, to); }
-    void erase(size_t at) { _if->erase(_p, at, at + 1); }
+    void erase(size_t from, size_t to) { this->_touch(), _if->erase(_p, from, to); }
+    void erase(size_t at) { erase(at, at + 1); }
 
     constexpr auto type() { return etype::from_type<Ty_>(); }
 
@@ -150,7 +359,7 @@ private:
  * Works similar way with vector specialization of \ref property_proxy
  */
 template <typename ValueTy_, bool Constant_>
-class property_proxy<u8str_map<ValueTy_>, Constant_> {
+class property_proxy<u8str_map<ValueTy_>, Constant_> : public _internal::_proxy_tracker<Constant_> {
 public:
     using Ty_ = u8str_map<ValueTy_>;
 
@@ -171,26 +380,39 @@ public:
 
 public:
     auto size() const { return _p->size(); }
-    auto& at(u8str_view s) { return _p->at(s); }
+    auto& at(u8str_view s) { return this->_touch(), _p->at(s); }
     auto& at(u8str_view s) const { return static_cast<const_pointer>(_p)->at(s); }
 
-    auto find(u8str_view s) const {
+    mapped_type const* find(u8str_view s) const {
         auto it = static_cast<const_pointer>(_p)->find(s);
         if (it == static_cast<const_pointer>(_p)->end()) { return nullptr; }
         return &it->second;
     }
 
     auto find(u8str_view s) {
+        using mapped_pointer = std::conditional_t<Constant_, mapped_type const*, mapped_type*>;
+        this->_touch();
         auto it = _p->find(s);
-        if (it == _p->end()) { return nullptr; }
-        return &it->second;
+        if (it == _p->end()) { return mapped_pointer{}; }
+        return mapped_pointer{&it->second};
+    }
+
+    mapped_type& insert(u8str_view s) {
+        this->_touch();
+        if (auto it = _p->find(s); it != _p->end()) { return it->second; }
+        return _p->try_emplace(u8str(s)).first->second;
+    }
+
+    void erase(u8str_view s) {
+        this->_touch();
+        if (auto it = _p->find(s); it != _p->end()) { _p->erase(it); }
     }
 
-    auto& insert(u8str_view s) { return _p[s]; }
-    void erase(u8str_view s) { _p->erase(s); }
+    void clear() { this->_touch(), _p->clear(); }
 
     template <typename Fn_>
     void for_each(Fn_&& fn) {
+        this->_touch();
         for (auto& pair : *_p) { fn(pair.first, pair.second); }
     }
 
@@ -209,7 +431,7 @@ private:
  * Works similar way with object vector specialization of \ref property_proxy
  */
 template <bool Constant_>
-class property_proxy<u8str_map<object>, Constant_> {
+class property_proxy<u8str_map<object>, Constant_> : public _internal::_proxy_tracker<Constant_> {
 public:
     using Vty_          = object;
     using Ty_           = u8str_map<object>;
@@ -228,15 +450,16 @@ public:
 
 public:
     auto size() const { return _if->size(_p); }
-    auto& at(u8str_view s) { return _if->at(_p, s); }
+    auto& at(u8str_view s) { return this->_touch(), _if->at(_p, s); }
     auto& at(u8str_view s) const { return _if->at(static_cast<const_pointer>(_p), s); }
-    auto find(u8str_view s) { return _if->find(_p, s); }
+    auto find(u8str_view s) { return this->_touch(), _if->find(_p, s); }
     auto find(u8str_view s) const { return _if->find(static_cast<const_pointer>(_p), s); }
-    auto& insert(u8str_view s) { return _if->insert(_p); }
-    void erase(u8str_view s) { _if->erase(_p, s); }
+    auto& insert(u8str_view s) { return this->_touch(), _if->insert(_p, s); }
+    void erase(u8str_view s) { this->_touch(), _if->erase(_p, s); }
+    void clear() { this->_touch(), _if->clear(_p); }
 
     template <typename Fn_>
-    void for_each(Fn_&& fn) { _if->for_each(_p, std::forward<Fn_>(fn)); }
+    void for_each(Fn_&& fn) { this->_touch(), _if->for_each(_p, std::forward<Fn_>(fn)); }
 
     template <typename Fn_>
     void for_each(Fn_&& fn) const { _if->for_each(const_cast<const_pointer>(_p), std::forward<Fn_>(fn)); }
@@ -248,17 +471,106 @@ private:
     void_pointer _p;
 };
 
+/**
+ * Marks property as modified, if its owner object tracks changes.
+ */
+inline void mark_dirty(object_baseaddr_t* base, property::memory_t const& m) {
+    if (m.owner == nullptr || m.owner->state_offset() < 0) { return; }
+    auto state = reinterpret_cast<object_state*>(reinterpret_cast<char*>(base) + m.owner->state_offset());
+    state->mark_dirty(m.index);
+}
+
+inline void mark_dirty(object& obj, property const& prop) { mark_dirty(obj.base(), prop.memory()); }
+
+/**
+ * Parses deferred value of property, if its owner object has one. Deferred values are parsed
+ *on first access through \ref make_proxy, even if accessed as const; thus concurrent reads of
+ *an object which has deferred values are not safe.
+ */
+inline void materialize(object_baseaddr_t const* base, property const& prop) {
+    auto& m = prop.memory();
+    if (m.owner == nullptr || m.owner->state_offset() < 0) { return; }
+
+    auto addr  = const_cast<char*>(reinterpret_cast<char const*>(base));
+    auto state = reinterpret_cast<object_state*>(addr + m.owner->state_offset());
+    if (state->any_deferred()) { state->materialize(reinterpret_cast<object_baseaddr_t*>(addr), m.index, prop); }
+}
+
+/** Parses every deferred value of object. Required before accessing members directly. */
+inline void materialize(object const& obj) {
+    if (auto state = obj.state(); state && state->any_deferred()) {
+        for (auto& prop : obj.properties()) { materialize(obj.base(), prop); }
+    }
+}
+
 /**
  * Creates property proxy from object instance and property.
  *
- * Runtime type check will be performed.
+ * Runtime type check will be performed. Non-const proxy marks the property dirty on each access
+ *which can modify it, rather than on creation; thus inspecting size or reading through const
+ *overloads keeps cached fragments valid.
  */
 template <typename Ty_, typename Vp, typename PropTy_>
 auto make_proxy(Vp* base, PropTy_ const& m) {
     enum { is_constant = std::is_const_v<Vp> };
-    return property_proxy<Ty_, is_constant>{m, m.memory()(base)};
+    if constexpr (std::is_same_v<PropTy_, property>) { materialize(base, m); }
+
+    property_proxy<Ty_, is_constant> proxy{m, m.memory()(base)};
+    if constexpr (!is_constant) {
+        if (auto& mem = m.memory(); mem.owner && mem.owner->state_offset() >= 0) {
+            proxy._track(reinterpret_cast<object_state*>(reinterpret_cast<char*>(base) + mem.owner->state_offset()), mem.index);
+        }
+    }
+    return proxy;
 }
 
+namespace _internal {
+template <typename Ty_> using _as_value  = Ty_;
+template <typename Ty_> using _as_vector = std::vector<Ty_>;
+template <typename Ty_> using _as_map    = u8str_map<Ty_>;
+
+template <typename Ty_> using _as_fixed_array  = fixed_array_t<Ty_>;
+template <typename Ty_> using _as_small_vector = small_vector_base<Ty_>;
+template <typename Ty_> using _as_nested       = nested_vector<Ty_>;
+
+/** Resolves actual storage width of numeric property from its subtype, then invokes handler. */
+template <template <typename> class Wrap_, typename BasePtr_, typename PropTy_, typename HandleFn_>
+decltype(auto) _visit_numeric(BasePtr_* obj, PropTy_ const& pr, HandleFn_&& fn) {
+    switch (pr.memory().subtype) {
+        case esubtype::i8: return fn(make_proxy<Wrap_<int8_t>>(obj, pr));
+        case esubtype::i16: return fn(make_proxy<Wrap_<int16_t>>(obj, pr));
+        case esubtype::i32: return fn(make_proxy<Wrap_<int32_t>>(obj, pr));
+        case esubtype::i64: return fn(make_proxy<Wrap_<int64_t>>(obj, pr));
+        case esubtype::u8: return fn(make_proxy<Wrap_<uint8_t>>(obj, pr));
+        case esubtype::u16: return fn(make_proxy<Wrap_<uint16_t>>(obj, pr));
+        case esubtype::u32: return fn(make_proxy<Wrap_<uint32_t>>(obj, pr));
+        case esubtype::u64: return fn(make_proxy<Wrap_<uint64_t>>(obj, pr));
+        case esubtype::f32: return fn(make_proxy<Wrap_<float>>(obj, pr));
+        case esubtype::f64: return fn(make_proxy<Wrap_<double>>(obj, pr));
+        default: assert(0 && "invalid numeric subtype specified.");
+    }
+
+    throw;
+}
+
+/** Dispatches array layouts which only accept primitive element types. */
+template <template <typename> class Wrap_, typename BasePtr_, typename PropTy_, typename HandleFn_>
+decltype(auto) _visit_primitive_array(BasePtr_* obj, PropTy_ const& pr, HandleFn_&& fn) {
+    switch (pr.memory().type.leap()) {
+        case etype::null: return fn(make_proxy<Wrap_<nullptr_t>>(obj, pr));
+        case etype::boolean: return fn(make_proxy<Wrap_<boolean_t>>(obj, pr));
+        case etype::integer: [[fallthrough]];
+        case etype::floating_point: return _visit_numeric<Wrap_>(obj, pr, fn);
+        case etype::string: return fn(make_proxy<Wrap_<u8str>>(obj, pr));
+        case etype::timestamp: return fn(make_proxy<Wrap_<timestamp_t>>(obj, pr));
+        case etype::binary: return fn(make_proxy<Wrap_<binary_chunk>>(obj, pr));
+        default: assert(0 && "object element is not supported for this array layout.");
+    }
+
+    throw;
+}
+} // namespace _internal
+
 /**
  * \brief On property, invoke operation which will be applied on its actual underlying type. 
  * \tparam BasePtr_ 'object' or 'object const'
@@ -280,8 +592,8 @@ decltype(auto) visit_property(BasePtr_* obj, PropTy_ const& pr, HandleFn_&& fn)
     switch (m.type.get()) {
         case etype::null: return fn(make_proxy<nullptr_t>(obj, pr));
         case etype::boolean: return fn(make_proxy<boolean_t>(obj, pr));
-        case etype::integer: return fn(make_proxy<integer_t>(obj, pr));
-        case etype::floating_point: return fn(make_proxy<float_t>(obj, pr));
+        case etype::integer: [[fallthrough]];
+        case etype::floating_point: return _internal::_visit_numeric<_internal::_as_value>(obj, pr, fn);
         case etype::string: return fn(make_proxy<u8str>(obj, pr));
         case etype::timestamp: return fn(make_proxy<timestamp_t>(obj, pr));
         case etype::binary: return fn(make_proxy<binary_chunk>(obj, pr));
@@ -291,11 +603,20 @@ decltype(auto) visit_property(BasePtr_* obj, PropTy_ const& pr, HandleFn_&& fn)
 
     if constexpr (std::is_same_v<PropTy_, property>) {
         if (m.type.is_array()) {
+            switch (m.layout) {
+                case elayout::fixed: return _internal::_visit_primitive_array<_internal::_as_fixed_array>(obj, pr, fn);
+                case elayout::inlined: return _internal::_visit_primitive_array<_internal::_as_small_vector>(obj, pr, fn);
+                case elayout::nested: return _internal::_visit_primitive_array<_internal::_as_nested>(obj, pr, fn);
+                default:;
+            }
+
             switch (m.type.leap()) {
                 case etype::null: return fn(make_proxy<std::vector<nullptr_t>>(obj, pr));
-                case etype::boolean: return fn(make_proxy<std::vector<boolean_t>>(obj, pr));
-                case etype::integer: return fn(make_proxy<std::vector<integer_t>>(obj, pr));
-                case etype::floating_point: return fn(make_proxy<std::vector<float_t>>(obj, pr));
+                case etype::boolean:
+                    if (m.subtype == esubtype::bit) { return fn(make_proxy<bit_vector>(obj, pr)); }
+                    return fn(make_proxy<std::vector<boolean_t>>(obj, pr));
+                case etype::integer: [[fallthrough]];
+                case etype::floating_point: return _internal::_visit_numeric<_internal::_as_vector>(obj, pr, fn);
                 case etype::string: return fn(make_proxy<std::vector<u8str>>(obj, pr));
                 case etype::timestamp: return fn(make_proxy<std::vector<timestamp_t>>(obj, pr));
                 case etype::binary: return fn(make_proxy<std::vector<binary_chunk>>(obj, pr));
@@ -306,8 +627,8 @@ decltype(auto) visit_property(BasePtr_* obj, PropTy_ const& pr, HandleFn_&& fn)
             switch (m.type.leap()) {
                 case etype::null: return fn(make_proxy<u8str_map<nullptr_t>>(obj, pr));
                 case etype::boolean: return fn(make_proxy<u8str_map<boolean_t>>(obj, pr));
-                case etype::integer: return fn(make_proxy<u8str_map<integer_t>>(obj, pr));
-                case etype::floating_point: return fn(make_proxy<u8str_map<float_t>>(obj, pr));
+                case etype::integer: [[fallthrough]];
+                case etype::floating_point: return _internal::_visit_numeric<_internal::_as_map>(obj, pr, fn);
                 case etype::string: return fn(make_proxy<u8str_map<u8str>>(obj, pr));
                 case etype::timestamp: return fn(make_proxy<u8str_map<timestamp_t>>(obj, pr));
                 case etype::binary: return fn(make_proxy<u8str_map<binary_chunk>>(obj, pr));
@@ -1,5 +1,6 @@
 #pragma once
 #include "object.hxx"
+#include "../utility/object_pool.hxx"
 
 /**
  * Static object interface ...
@@ -10,11 +11,21 @@ namespace kangsw::refl {
 
 using static_object_list = templates::singleton<std::vector<object_traits const*>>;
 
+namespace _internal {
+inline u8str qualify_type_name(u8str_view enclosing, u8str_view name) {
+    if (enclosing.empty()) { return u8str(name); }
+
+    u8str r;
+    r.reserve(enclosing.size() + 2 + name.size());
+    return r.append(enclosing).append("::").append(name);
+}
+} // namespace _internal
+
 template <typename ObjTy_>
 class static_object_traits : public object_traits {
 private:
     friend struct templates::singleton<static_object_traits, ObjTy_>;
-    static_object_traits() = default;
+    static_object_traits() { (void)&_reg; } // odr-use, otherwise registration is never instantiated
 
     static inline struct register_traits {
         register_traits() {
@@ -27,13 +38,43 @@ public:
         return templates::singleton<static_object_traits, ObjTy_>::get();
     }
 
+    u8str_view name() const override {
+        static u8str const type_name = ObjTy_::type_name();
+        return type_name;
+    }
+
     std::unique_ptr<object> create_empty_object() override {
         return std::make_unique<ObjTy_>();
     }
+
+    pooled_object acquire_object() const override {
+        if (auto p = object_pool<ObjTy_>::pop()) { return pooled_object{p}; }
+
+        pooled_object o{new ObjTy_};
+        o->reset();
+        return o;
+    }
+
+    void release_object(object* p) const noexcept override {
+        auto o = static_cast<ObjTy_*>(p);
+        try {
+            o->reset();
+        } catch (...) {
+            delete o;
+            return;
+        }
+
+        if (!object_pool<ObjTy_>::push(o)) { delete o; }
+    }
 };
 
-/**  */
-template <typename Ty_>
+/**
+ * Base of static object types.
+ *
+ * NameTy_ provides stable name of the type through static get(), which is generated by
+ *CPPMARKUP_OBJECT_TEMPLATE. Types without NameTy_ have empty name.
+ */
+template <typename Ty_, typename NameTy_ = void>
 class static_object_base : public object {
 public:
     using self_type   = Ty_;
@@ -41,6 +82,17 @@ public:
 
 public:
     object_traits const& traits() const override { return traits_type::get(); }
+
+    static u8str type_name() {
+        if constexpr (std::is_void_v<NameTy_>) {
+            return {};
+        } else {
+            return NameTy_::get();
+        }
+    }
+
+    // Object types declared inside this type will be qualified with this name.
+    static u8str cppmarkup_enclosing_type_name() { return type_name(); }
     static Ty_ get_default() {
         Ty_ o;
         return o.reset(), o;
@@ -79,7 +131,7 @@ public:
         vec.erase(vec.begin() + from, vec.begin() + to);
     }
 
-    void reserve(void* p, size_t new_size) override {
+    void reserve(void* p, size_t new_size) const override {
         static_cast<ptr>(p)->reserve(new_size);
     }
 };
@@ -128,6 +180,10 @@ public:
         map.erase(it);
     }
 
+    void clear(void* p) const override {
+        static_cast<ptr>(p)->clear();
+    }
+
     void for_each(void* p, std::function<void(u8str_view, object&)> const& fn) const override {
         for (auto& pair : *static_cast<ptr>(p)) { fn(pair.first, pair.second); }
     }
@@ -151,10 +207,19 @@ public:
         auto& prop        = traits_type::get().find_or_add_property(tag);
 
         constexpr auto type = etype::from_type<ValueTy_>();
+        if constexpr (templates::is_sized_specialization_of<ValueTy_, std::array>::value) {
+            // extent of fixed array is resolved from memory size in runtime.
+            static_assert(sizeof(ValueTy_) == sizeof(typename ValueTy_::value_type) * std::tuple_size_v<ValueTy_>);
+        }
+
         property::memory_t m;
-        m.type   = type;
-        m.size   = sizeof(ValueTy_);
-        m.offset = offset;
+        m.type    = type;
+        m.subtype = etype::subtype_from_type<ValueTy_>();
+        m.layout  = etype::layout_from_type<ValueTy_>();
+        m.size    = sizeof(ValueTy_);
+        m.offset  = offset;
+        m.owner   = &traits_type::get();
+        m.index   = &prop - traits_type::get().props().data();
 
         m.init_fn = [_v = std::move(initial_value)](void* pv) {
             *(ValueTy_*)pv = _v;
@@ -164,13 +229,16 @@ public:
 
         if constexpr (type.is_object()) {
             if constexpr (type.is_array()) {
-                prop._set_ovi(new static_object_vector_iface<typename ValueTy_::value_type>);
+                using object_type = typename ValueTy_::value_type;
+                prop._set_ovi(new static_object_vector_iface<object_type>);
+                prop._set_traits(&static_object_traits<object_type>::get());
+            } else if constexpr (type.is_map()) {
+                using object_type = typename ValueTy_::mapped_type;
+                prop._set_omi(new static_object_map_iface<object_type>);
+                prop._set_traits(&static_object_traits<object_type>::get());
+            } else {
+                prop._set_traits(&static_object_traits<ValueTy_>::get());
             }
-            if constexpr (type.is_map()) {
-                prop._set_omi(new static_object_map_iface<typename ValueTy_::mapped_type>);
-            }
-
-            prop._set_traits(&traits_type::get());
         }
     }
 };
@@ -189,10 +257,14 @@ public:
         auto& prop        = traits_type::get().find_or_add_property(tag);
 
         property::attribute attr;
-        attr.name           = std::move(name);
-        attr._memory.size   = sizeof(ValueTy_);
-        attr._memory.offset = offset;
-        attr._memory.type   = etype::from_type<ValueTy_>();
+        attr.name            = std::move(name);
+        attr._memory.size    = sizeof(ValueTy_);
+        attr._memory.offset  = offset;
+        attr._memory.type    = etype::from_type<ValueTy_>();
+        attr._memory.subtype = etype::subtype_from_type<ValueTy_>();
+        attr._memory.layout  = etype::layout_from_type<ValueTy_>();
+        attr._memory.owner   = &traits_type::get();
+        attr._memory.index   = &prop - traits_type::get().props().data();
 
         constexpr auto type = etype::from_type<ValueTy_>();
         static_assert(!type.is_container());
@@ -206,4 +278,13 @@ public:
     }
 };
 
-} // namespace kangsw::refl
\ No newline at end of file
+/** Registers change tracking block of object */
+template <typename ObjTy_>
+class state_registration_t {
+public:
+    state_registration_t(size_t offset) {
+        static_object_traits<ObjTy_>::get()._set_state_offset(offset);
+    }
+};
+
+} // namespace kangsw::refl
@@ -0,0 +1,163 @@
+#pragma once
+#include <stdexcept>
+#include "hash.hxx"
+#include "static_object_base.hxx"
+
+namespace kangsw::refl {
+
+struct type_name_collision_exception : std::logic_error {
+    using std::logic_error::logic_error;
+};
+
+namespace _internal {
+inline void _hash_schema(hasher& h, object_traits const& traits, std::vector<object_traits const*>& visiting) {
+    if (std::find(visiting.begin(), visiting.end(), &traits) != visiting.end()) {
+        // recursive type refers itself by its name.
+        h.update("@", 1), h.update(traits.name().data(), traits.name().size());
+        return;
+    }
+
+    auto const hash_memory = [&h](property::memory_t const& m) {
+        h.update_value(m.type.get()), h.update_value(m.subtype), h.update_value(m.layout);
+        if (m.layout == elayout::fixed) { h.update_value(m.size); }
+    };
+
+    visiting.push_back(&traits);
+    h.update_value(traits.props().size());
+
+    for (auto& prop : traits.props()) {
+        h.update_value(prop.tag().size()), h.update(prop.tag().data(), prop.tag().size());
+        hash_memory(prop.memory());
+
+        h.update_value(prop.attributes().size());
+        for (auto& attr : prop.attributes()) {
+            h.update_value(attr.name.size()), h.update(attr.name.data(), attr.name.size());
+            hash_memory(attr.memory());
+        }
+
+        if (prop.type().is_object()) { _hash_schema(h, prop.get_object_traits(), visiting); }
+    }
+
+    visiting.pop_back();
+}
+} // namespace _internal
+
+/**
+ * Computes fingerprint of schema, which covers tags, types and attributes of every property,
+ *including schema of nested object types.
+ *
+ * Memory layout and type names are not covered, thus two types of same shape share fingerprint.
+ */
+inline uint64_t schema_fingerprint(object_traits const& traits) {
+    hasher h;
+    std::vector<object_traits const*> visiting;
+    _internal::_hash_schema(h, traits, visiting);
+    return h.digest();
+}
+
+/**
+ * Frozen hash index of object types by name.
+ *
+ * Built once, then never modified; lookup is a single probe sequence over open addressing
+ *table, thus constant time regardless of number of types. Types without name are excluded.
+ *
+ * Type names are qualified by enclosing object types, but not by namespaces; thus same-named
+ *types in different namespaces collide. Such types should be declared with
+ *CPPMARKUP_NAMED_OBJECT_TEMPLATE and unique names to be looked up.
+ */
+class type_registry {
+public:
+    struct entry {
+        u8str_view name;
+        uint64_t fingerprint;
+        object_traits const* traits;
+        bool ambiguous = false; // shared by two or more different types
+    };
+
+public:
+    /**
+     * Names shared by two or more different types are kept as ambiguous entries, which don't
+     *prevent lookup of other names.
+     */
+    explicit type_registry(std::vector<object_traits const*> const& types) {
+        size_t num_slots = 1;
+        while (num_slots < types.size() * 2) { num_slots <<= 1; }
+        _slots.resize(num_slots);
+        _mask = num_slots - 1;
+        _entries.reserve(types.size());
+
+        for (auto traits : types) {
+            auto const name = traits->name();
+            if (name.empty()) { continue; }
+
+            auto const hash = _hash(name);
+            for (auto pos = hash & _mask;; pos = (pos + 1) & _mask) {
+                auto& slot = _slots[pos];
+                if (slot.index == 0) {
+                    _entries.push_back({name, schema_fingerprint(*traits), traits});
+                    slot = {hash, _entries.size()};
+                    break;
+                }
+
+                auto& e = _entries[slot.index - 1];
+                if (slot.hash == hash && e.name == name) {
+                    e.ambiguous |= e.traits != traits;
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * Index of every static object type. Built on first call, thus every type which was
+     *registered during static initialization is included.
+     */
+    static type_registry const& global() {
+        static type_registry const registry{static_object_list::get()};
+        return registry;
+    }
+
+public:
+    /** Throws type_name_collision_exception if the name is shared by different types. */
+    entry const* find(u8str_view name) const {
+        auto const hash = _hash(name);
+        for (auto pos = hash & _mask;; pos = (pos + 1) & _mask) {
+            auto& slot = _slots[pos];
+            if (slot.index == 0) { return nullptr; }
+
+            auto& e = _entries[slot.index - 1];
+            if (slot.hash == hash && e.name == name) {
+                if (e.ambiguous) { throw type_name_collision_exception{u8str(name)}; }
+                return &e;
+            }
+        }
+    }
+
+    object_traits const* find_traits(u8str_view name) const {
+        auto e = find(name);
+        return e ? e->traits : nullptr;
+    }
+
+    size_t size() const { return _entries.size(); }
+    auto begin() const { return _entries.cbegin(); }
+    auto end() const { return _entries.cend(); }
+
+private:
+    static uint64_t _hash(u8str_view name) {
+        hasher h;
+        h.update(name.data(), name.size());
+        return h.digest();
+    }
+
+private:
+    struct _slot {
+        uint64_t hash = 0;
+        size_t index  = 0; // 1-based index of entry, 0 if empty
+    };
+
+    std::vector<entry> _entries;
+    std::vector<_slot> _slots;
+    uint64_t _mask = 0;
+};
+
+} // namespace kangsw::refl
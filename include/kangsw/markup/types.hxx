@@ -1,5 +1,9 @@
 #pragma once
 #include "utility/template_utils.hxx"
+#include "utility/small_vector.hxx"
+#include "utility/nested_vector.hxx"
+#include <algorithm>
+#include <array>
 #include <stdexcept>
 #include <iterator>
 #include <string>
@@ -88,6 +92,201 @@ struct boolean_t {
     bool _value;
 };
 
+/**
+ * Bit-packed boolean array, which stores single bit per element.
+ *
+ * Opt-in replacement of std::vector<boolean_t>. Bulk operations are performed word-at-a-time.
+ */
+class bit_vector {
+public:
+    using word_type  = uint64_t;
+    using value_type = boolean_t;
+
+    static constexpr size_t word_bits = sizeof(word_type) * 8;
+
+    /** Proxy reference of single bit */
+    class reference {
+    public:
+        reference(word_type& word, word_type mask) noexcept : _word(&word), _mask(mask) {}
+
+        reference& operator=(bool value) noexcept { return *_word = value ? *_word | _mask : *_word & ~_mask, *this; }
+        reference& operator=(reference const& other) noexcept { return *this = bool(other); }
+        operator bool() const noexcept { return *_word & _mask; }
+
+    private:
+        word_type* _word;
+        word_type _mask;
+    };
+
+public:
+    bit_vector() noexcept = default;
+    bit_vector(std::initializer_list<bool> il) : bit_vector(il.begin(), il.end()) {}
+    explicit bit_vector(size_t n, bool value = false) { resize(n, value); }
+
+    template <typename It_, typename = typename std::iterator_traits<It_>::iterator_category>
+    bit_vector(It_ begin, It_ end) {
+        for (; begin != end; ++begin) { push_back(*begin); }
+    }
+
+public:
+    size_t size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+    size_t capacity() const noexcept { return _words.capacity() * word_bits; }
+
+    void reserve(size_t n) { _words.reserve(_num_words(n)); }
+    void clear() noexcept { _words.clear(), _size = 0; }
+
+    void resize(size_t n, bool value = false) {
+        if (n > _size && value) {
+            _words.resize(_num_words(n), ~word_type{});
+            if (_size % word_bits) { _words[_size / word_bits] |= ~word_type{} << (_size % word_bits); }
+        } else {
+            _words.resize(_num_words(n));
+        }
+
+        _size = n, _trim();
+    }
+
+    void push_back(bool value) {
+        if (_size % word_bits == 0) { _words.push_back(0); }
+        (*this)[_size++] = value;
+    }
+
+    reference emplace_back() { return push_back(false), (*this)[_size - 1]; }
+
+    /** Erases bits in range [from, to). Trailing bits are shifted. */
+    void erase(size_t from, size_t to) {
+        for (size_t src = to, dst = from; src < _size; ++src, ++dst) { (*this)[dst] = test(src); }
+        _size -= to - from;
+        _words.resize(_num_words(_size)), _trim();
+    }
+
+    bool test(size_t i) const noexcept { return _words[i / word_bits] & _mask(i); }
+    bool operator[](size_t i) const noexcept { return test(i); }
+    reference operator[](size_t i) noexcept { return {_words[i / word_bits], _mask(i)}; }
+
+    auto& words() const noexcept { return _words; }
+
+public:
+    bit_vector& set() noexcept { return std::fill(_words.begin(), _words.end(), ~word_type{}), _trim(), *this; }
+    bit_vector& reset() noexcept { return std::fill(_words.begin(), _words.end(), word_type{}), *this; }
+    bit_vector& flip() noexcept {
+        for (auto& w : _words) { w = ~w; }
+        return _trim(), *this;
+    }
+
+    size_t count() const noexcept {
+        size_t n = 0;
+        for (auto w : _words) { n += _popcount(w); }
+        return n;
+    }
+
+    bool any() const noexcept { return std::any_of(_words.begin(), _words.end(), [](word_type w) { return w != 0; }); }
+    bool none() const noexcept { return !any(); }
+    bool all() const noexcept { return count() == _size; }
+
+    /** Bitwise operations between two bit vectors. Shorter operand is treated as zero-extended. */
+    bit_vector& operator&=(bit_vector const& r) noexcept {
+        for (size_t i = 0; i < _words.size(); ++i) { _words[i] &= i < r._words.size() ? r._words[i] : 0; }
+        return *this;
+    }
+
+    bit_vector& operator|=(bit_vector const& r) noexcept {
+        for (size_t i = 0, n = std::min(_words.size(), r._words.size()); i < n; ++i) { _words[i] |= r._words[i]; }
+        return _trim(), *this;
+    }
+
+    bit_vector& operator^=(bit_vector const& r) noexcept {
+        for (size_t i = 0, n = std::min(_words.size(), r._words.size()); i < n; ++i) { _words[i] ^= r._words[i]; }
+        return _trim(), *this;
+    }
+
+    bool operator==(bit_vector const& r) const noexcept { return _size == r._size && _words == r._words; }
+    bool operator!=(bit_vector const& r) const noexcept { return !(*this == r); }
+
+public:
+    /** Appends packed representation, which is ceil(size/8) bytes of LSB-first bits. For binary marshal formats. */
+    void pack_into(binary_chunk& out) const {
+        auto const n_bytes = (_size + 7) / 8;
+        out.reserve(out.size() + n_bytes);
+
+        for (size_t i = 0; i < n_bytes; ++i) {
+            out.push_back(std::byte(_words[i / sizeof(word_type)] >> (i % sizeof(word_type) * 8)));
+        }
+    }
+
+    /** Restores bit vector from packed representation */
+    static bit_vector unpack(void const* data, size_t num_bits) {
+        bit_vector out;
+        auto const bytes = static_cast<uint8_t const*>(data);
+        out._words.resize(_num_words(num_bits));
+        out._size = num_bits;
+
+        for (size_t i = 0, n_bytes = (num_bits + 7) / 8; i < n_bytes; ++i) {
+            out._words[i / sizeof(word_type)] |= word_type(bytes[i]) << (i % sizeof(word_type) * 8);
+        }
+
+        return out._trim(), out;
+    }
+
+private:
+    static constexpr size_t _num_words(size_t n) noexcept { return (n + word_bits - 1) / word_bits; }
+    static constexpr word_type _mask(size_t i) noexcept { return word_type{1} << (i % word_bits); }
+
+    static constexpr size_t _popcount(word_type w) noexcept {
+        w = w - ((w >> 1) & 0x5555555555555555);
+        w = (w & 0x3333333333333333) + ((w >> 2) & 0x3333333333333333);
+        w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0f;
+        return (w * 0x0101010101010101) >> 56;
+    }
+
+    // Keeps unused bits of the last word zero, so word-wise comparison and counting stays valid.
+    void _trim() noexcept {
+        if (_size % word_bits) { _words.back() &= ~word_type{} >> (word_bits - _size % word_bits); }
+    }
+
+private:
+    std::vector<word_type> _words;
+    size_t _size = 0;
+};
+
+/**
+ * Represents std::array<Ty_, N> of any extent.
+ *
+ * Since extent of fixed array can only be known in runtime on reflection, this tag is used as
+ *type-erased form of fixed array property.
+ */
+template <typename Ty_>
+struct fixed_array_t {
+    using value_type = Ty_;
+};
+
+/** storage layout of array elements */
+enum class elayout : uint8_t {
+    dynamic = 0x00, // std::vector
+    fixed   = 0x01, // std::array, of which extent is fixed
+    inlined = 0x02, // small_vector, which stores elements inline until exceeds its capacity
+    nested  = 0x03, // nested_vector, array of arrays in CSR layout
+};
+
+/** element storage subtype. Preserves declared width of numeric elements, and packed form of boolean arrays. */
+enum class esubtype : uint8_t {
+    none = 0x00, // non-numeric types
+
+    i8  = 0x01,
+    i16 = 0x02,
+    i32 = 0x03,
+    i64 = 0x04,
+    u8  = 0x05,
+    u16 = 0x06,
+    u32 = 0x07,
+    u64 = 0x08,
+    f32 = 0x09,
+    f64 = 0x0a,
+
+    bit = 0x10, // bit-packed boolean array
+};
+
 /** element type */
 class etype {
 public:
@@ -151,6 +350,8 @@ public:
         // clang-format off
         if      constexpr(is_same_v<eval_type, bool>) { return boolean; }
         else if constexpr(is_same_v<eval_type, boolean_t>) { return boolean; }
+        else if constexpr(is_same_v<eval_type, bit_vector::reference>) { return boolean; }
+        else if constexpr(is_same_v<eval_type, bit_vector>) { return array | boolean; }
         else if constexpr(is_same_v<eval_type, nullptr_t>) { return null; }
         else if constexpr(is_same_v<eval_type, binary_chunk>) { return binary; }
         else if constexpr(is_integral_v<eval_type>) { return integer ; }
@@ -164,6 +365,21 @@ public:
             static_assert(!from_type<value_type>().is_container(), "nested container is not supported.");
             return array | from_type<value_type>();
         }
+        else if constexpr(_is_inline_array_v<eval_type>) {
+            using value_type = typename eval_type::value_type;
+            static_assert(!from_type<value_type>().is_container(), "nested container is not supported.");
+            static_assert(!from_type<value_type>().is_object(), "fixed or inlined array of object is not supported.");
+            return array | from_type<value_type>();
+        }
+        else if constexpr(is_specialization_of<eval_type, row_view>::value) {
+            return array | from_type<typename eval_type::value_type>();
+        }
+        else if constexpr(is_specialization_of<eval_type, nested_vector>::value) {
+            using value_type = typename eval_type::value_type;
+            static_assert(!from_type<value_type>().is_container(), "nested container is only supported as nested_vector.");
+            static_assert(!from_type<value_type>().is_object(), "nested array of object is not supported.");
+            return array | from_type<value_type>();
+        }
         else if constexpr(is_specialization_of<eval_type, u8str_map>::value) {
             using mapped_type = typename eval_type::mapped_type;
             static_assert(!from_type<mapped_type>().is_container(), "nested container is not supported.");
@@ -183,8 +399,9 @@ public:
         // clang-format off
         if      constexpr(is_same_v<Ty_, nullptr_t>) { return null; }
         else if constexpr(is_same_v<Ty_, boolean_t>) { return boolean; }
-        else if constexpr(is_same_v<Ty_, int64_t>) { return integer; }
-        else if constexpr(is_same_v<Ty_, double>) { return floating_point; }
+        else if constexpr(is_same_v<Ty_, bit_vector>) { return array | boolean; }
+        else if constexpr(_is_fixed_width_v<Ty_> && is_integral_v<Ty_>) { return integer; }
+        else if constexpr(_is_fixed_width_v<Ty_> && is_floating_point_v<Ty_>) { return floating_point; }
         else if constexpr(is_same_v<Ty_, u8str>) { return string; }
         else if constexpr(is_same_v<Ty_, binary_chunk>) { return binary; }
         else if constexpr(is_same_v<Ty_, timestamp_t>) { return timestamp; }
@@ -194,6 +411,12 @@ public:
             static_assert(!from_type_exact<value_type>().is_container(), "nested container is not supported.");
             return array | from_type_exact<value_type>();
         }
+        else if constexpr(is_specialization_of<eval_type, fixed_array_t>::value || is_specialization_of<eval_type, small_vector_base>::value
+                          || is_specialization_of<eval_type, nested_vector>::value) {
+            using value_type = typename eval_type::value_type;
+            static_assert(!from_type_exact<value_type>().is_container(), "nested container is not supported.");
+            return array | from_type_exact<value_type>();
+        }
         else if constexpr(is_specialization_of<eval_type, u8str_map>::value) {
             using mapped_type = typename eval_type::mapped_type;
             static_assert(is_same_v<u8str, typename eval_type::key_type>, "key of map type must be 'u8str'");
@@ -204,6 +427,92 @@ public:
         // clang-format on
     }
 
+    /** Retrieves storage subtype of given type. Containers are evaluated by their value type. */
+    template <typename Ty_>
+    constexpr static esubtype subtype_from_type() {
+        using namespace templates;
+        using namespace std;
+        using eval_type = std::remove_const_t<std::remove_reference_t<Ty_>>;
+
+        // clang-format off
+        if      constexpr(is_specialization_of<eval_type, std::vector>::value) { return subtype_from_type<typename eval_type::value_type>(); }
+        else if constexpr(_is_inline_array_v<eval_type>) { return subtype_from_type<typename eval_type::value_type>(); }
+        else if constexpr(is_specialization_of<eval_type, nested_vector>::value) { return subtype_from_type<typename eval_type::value_type>(); }
+        else if constexpr(is_specialization_of<eval_type, u8str_map>::value) { return subtype_from_type<typename eval_type::mapped_type>(); }
+        else if constexpr(is_same_v<eval_type, bit_vector>) { return esubtype::bit; }
+        else if constexpr(is_same_v<eval_type, bool>) { return esubtype::none; }
+        else if constexpr(is_arithmetic_v<eval_type>) { return _subtype_from_fixed<_fixed_width_t<eval_type>>(); }
+        else { return esubtype::none; }
+        // clang-format on
+    }
+
+    /** Retrieves storage layout of given array type */
+    template <typename Ty_>
+    constexpr static elayout layout_from_type() {
+        using namespace templates;
+        using eval_type = std::remove_const_t<std::remove_reference_t<Ty_>>;
+
+        // clang-format off
+        if      constexpr(is_sized_specialization_of<eval_type, std::array>::value) { return elayout::fixed; }
+        else if constexpr(is_specialization_of<eval_type, fixed_array_t>::value) { return elayout::fixed; }
+        else if constexpr(is_sized_specialization_of<eval_type, small_vector>::value) { return elayout::inlined; }
+        else if constexpr(is_specialization_of<eval_type, small_vector_base>::value) { return elayout::inlined; }
+        else if constexpr(is_specialization_of<eval_type, nested_vector>::value) { return elayout::nested; }
+        else { return elayout::dynamic; }
+        // clang-format on
+    }
+
+private:
+    /** Arrays which don't allocate; std::array, small_vector, and their type-erased forms */
+    template <typename Ty_>
+    static constexpr bool _is_inline_array_v = layout_from_type<Ty_>() == elayout::fixed || layout_from_type<Ty_>() == elayout::inlined;
+
+    template <typename Ty_>
+    static constexpr bool _is_fixed_width_v =
+      std::is_same_v<Ty_, int8_t> || std::is_same_v<Ty_, int16_t> || std::is_same_v<Ty_, int32_t> || std::is_same_v<Ty_, int64_t> ||
+      std::is_same_v<Ty_, uint8_t> || std::is_same_v<Ty_, uint16_t> || std::is_same_v<Ty_, uint32_t> || std::is_same_v<Ty_, uint64_t> ||
+      std::is_same_v<Ty_, float> || std::is_same_v<Ty_, double>;
+
+    /** Maps arbitrary arithmetic type into fixed width type which has same size and signedness */
+    template <typename Ty_>
+    static constexpr decltype(auto) _fixed_width_from() {
+        using eval_type = std::remove_cv_t<Ty_>;
+
+        // clang-format off
+        if      constexpr (std::is_floating_point_v<eval_type> && sizeof(eval_type) == sizeof(float)) { return static_cast<float*>(nullptr); }
+        else if constexpr (std::is_floating_point_v<eval_type>) { return static_cast<double*>(nullptr); }
+        else if constexpr (std::is_signed_v<eval_type> && sizeof(eval_type) == 1) { return static_cast<int8_t*>(nullptr); }
+        else if constexpr (std::is_signed_v<eval_type> && sizeof(eval_type) == 2) { return static_cast<int16_t*>(nullptr); }
+        else if constexpr (std::is_signed_v<eval_type> && sizeof(eval_type) == 4) { return static_cast<int32_t*>(nullptr); }
+        else if constexpr (std::is_signed_v<eval_type>) { return static_cast<int64_t*>(nullptr); }
+        else if constexpr (sizeof(eval_type) == 1) { return static_cast<uint8_t*>(nullptr); }
+        else if constexpr (sizeof(eval_type) == 2) { return static_cast<uint16_t*>(nullptr); }
+        else if constexpr (sizeof(eval_type) == 4) { return static_cast<uint32_t*>(nullptr); }
+        else { return static_cast<uint64_t*>(nullptr); }
+        // clang-format on
+    }
+
+    template <typename Ty_>
+    static constexpr esubtype _subtype_from_fixed() {
+        using namespace std;
+
+        // clang-format off
+        if      constexpr (is_same_v<Ty_, int8_t>) { return esubtype::i8; }
+        else if constexpr (is_same_v<Ty_, int16_t>) { return esubtype::i16; }
+        else if constexpr (is_same_v<Ty_, int32_t>) { return esubtype::i32; }
+        else if constexpr (is_same_v<Ty_, int64_t>) { return esubtype::i64; }
+        else if constexpr (is_same_v<Ty_, uint8_t>) { return esubtype::u8; }
+        else if constexpr (is_same_v<Ty_, uint16_t>) { return esubtype::u16; }
+        else if constexpr (is_same_v<Ty_, uint32_t>) { return esubtype::u32; }
+        else if constexpr (is_same_v<Ty_, uint64_t>) { return esubtype::u64; }
+        else if constexpr (is_same_v<Ty_, float>) { return esubtype::f32; }
+        else { return esubtype::f64; }
+        // clang-format on
+    }
+
+    template <typename Ty_>
+    using _fixed_width_t = std::remove_pointer_t<decltype(_fixed_width_from<Ty_>())>;
+
 private:
     template <int V_>
     static constexpr decltype(auto) _deduce_from_exact() {
@@ -255,7 +564,7 @@ public:
 
     template <typename Ty_>
     static decltype(auto) deduce(std::initializer_list<Ty_> v) {
-        return std::vector<_deduce_result_t<Ty_>>(v.begin(), v.end());
+        return std::vector<decltype(deduce(std::declval<Ty_>()))>(v.begin(), v.end());
     }
 
     template <typename Ty_>
@@ -268,6 +577,25 @@ public:
             return nullptr;
         } else if constexpr (templates::is_specialization_of<eval_type, std::vector>::value) {
             return std::vector<decltype(deduce(typename Ty_::value_type{}))>(v.begin(), v.end());
+        } else if constexpr (templates::is_sized_specialization_of<eval_type, std::array>::value) {
+            using value_type = typename eval_type::value_type;
+            std::array<decltype(deduce(value_type{})), std::tuple_size_v<eval_type>> out;
+            std::transform(v.begin(), v.end(), out.begin(), [](value_type const& e) { return deduce(value_type(e)); });
+            return out;
+        } else if constexpr (templates::is_sized_specialization_of<eval_type, small_vector>::value) {
+            using value_type = typename eval_type::value_type;
+            small_vector<decltype(deduce(value_type{})), eval_type::inline_capacity> out;
+            std::transform(v.begin(), v.end(), std::back_inserter(out), [](value_type const& e) { return deduce(value_type(e)); });
+            return out;
+        } else if constexpr (templates::is_specialization_of<eval_type, nested_vector>::value) {
+            using value_type = typename eval_type::value_type;
+            nested_vector<decltype(deduce(value_type{}))> out;
+            out.reserve(v.size(), v.num_values());
+            for (size_t i = 0; i < v.size(); ++i) {
+                out.emplace_back();
+                for (auto&& e : v[i]) { out.append(deduce(value_type(e))); }
+            }
+            return out;
         } else if constexpr (templates::is_specialization_of<eval_type, u8str_map>::value) {
             return u8str_map<decltype(deduce(typename Ty_::mapped_type{}))>(v.begin(), v.end());
         } else if constexpr (templates::is_specialization_of<eval_type, std::chrono::time_point>::value) {
@@ -283,8 +611,9 @@ public:
             else if constexpr(is_same_v<eval_type, boolean_t>) { return boolean_t(v); }
             else if constexpr(is_same_v<eval_type, nullptr_t>) { return nullptr; }
             else if constexpr(is_same_v<eval_type, binary_chunk>) { return binary_chunk{std::forward<Ty_>(v)}; }
-            else if constexpr(is_integral_v<eval_type>) { return integer_t(v); }
-            else if constexpr(is_floating_point_v<eval_type>) { return float_t(v); }
+            else if constexpr(is_same_v<eval_type, bit_vector>) { return bit_vector(std::forward<Ty_>(v)); }
+            else if constexpr(is_integral_v<eval_type>) { return _fixed_width_t<eval_type>(v); }
+            else if constexpr(is_floating_point_v<eval_type>) { return _fixed_width_t<eval_type>(v); }
             else if constexpr(is_same_v<eval_type, char const*>) { return u8str(v); }
 #if __cplusplus >= 202000
             else if constexpr(is_same_v<eval_type, char8_t const*>) { return u8str(reinterpret_cast<char const*>(v)); }
@@ -1,6 +1,20 @@
 #pragma once
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <string_view>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define INTERNAL_KANGSW_BASE64_AVX2  1
+#define INTERNAL_KANGSW_BASE64_SSSE3 1
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define INTERNAL_KANGSW_BASE64_SSSE3 1
+#endif
 
 namespace kangsw::base64 {
 
@@ -10,29 +24,16 @@ inline size_t decoded_size(size_t string_len) { return (string_len + 3) / 4 * 3;
 constexpr char _table_encode[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 constexpr char _padchar          = '=';
 
-constexpr uint8_t _table_decode[256] = {
-  // clang-format off
-    0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 
-    0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 
-    0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0x3e, 0xcc, 0xcc, 0xcc, 0x3f, 
-    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xcc, 0xcc, 0xcc, 0x00, 0xcc, 0xcc, 
-    0xcc, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 
-    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 
-    0xcc, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 
-    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 
-    0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 
-    0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 
-    0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 
-    0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 
-    0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 
-    0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 
-    0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 
-    0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc,
-  // clang-format on
-};
+/** 6-bit value of each character; 0xff for characters out of alphabet, including padding. */
+constexpr auto _table_decode = [] {
+    std::array<uint8_t, 256> table = {};
+    for (auto& v : table) { v = 0xff; }
+    for (uint8_t i = 0; i < 64; ++i) { table[uint8_t(_table_encode[i])] = i; }
+    return table;
+}();
 
 constexpr bool is_valid_b64_char(char ch) {
-    return _table_decode[ch] != 0xcc;
+    return _table_decode[uint8_t(ch)] != 0xff;
 }
 
 inline void _encode_blk(char* o, void const* i) {
@@ -43,60 +44,229 @@ inline void _encode_blk(char* o, void const* i) {
     o[3]    = _table_encode[ch[2] & 0x3f];
 }
 
-template <typename OutIt_>
-void encode(void const* data, size_t len, OutIt_&& o) {
-    for (; len >= 3; len -= 3, data = (void*)(intptr_t(data) + 3)) {
-        char oblk[4];
-        _encode_blk(oblk, data);
-
-        o = oblk[0];
-        o = oblk[1];
-        o = oblk[2];
-        o = oblk[3];
+#if INTERNAL_KANGSW_BASE64_SSSE3
+/*
+ * Vector kernels split 3 byte groups into 6-bit indices with multiplications, then translate them
+ *into characters by adding per-range offsets which are looked up through byte shuffle. Decoding
+ *validates characters by set of valid higher nibbles for each lower nibble.
+ */
+
+/** Encodes 12 bytes into 16 characters; reads 16 bytes. */
+inline void _encode16(uint8_t const* in, char* o) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    v         = _mm_shuffle_epi8(v, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+    auto const hi  = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    auto const lo  = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    auto const idx = _mm_or_si128(hi, lo);
+
+    auto range = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+    range      = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), idx), _mm_set1_epi8(13)));
+
+    auto const offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                       '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    auto const chars   = _mm_add_epi8(_mm_shuffle_epi8(offsets, range), idx);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(o), chars);
+}
+
+/** Decodes 16 characters into 12 bytes; writes 16 bytes. Returns false on invalid character. */
+inline bool _decode16(char const* in, uint8_t* o) {
+    auto const v      = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    auto const hi_nib = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi8(0x0f));
+    auto const lo_nib = _mm_and_si128(v, _mm_set1_epi8(0x0f));
+
+    auto const valid_hi = _mm_setr_epi8(char(0xa8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8),
+                                        char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf0), 0x54, 0x50,
+                                        0x50, 0x50, 0x54);
+    auto const hi_bit   = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, char(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+    auto const matched  = _mm_and_si128(_mm_shuffle_epi8(valid_hi, lo_nib), _mm_shuffle_epi8(hi_bit, hi_nib));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(matched, _mm_setzero_si128())) != 0) { return false; }
+
+    auto const offsets = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    auto const slash   = _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('/')), _mm_set1_epi8(16 - 19));
+    auto const idx     = _mm_add_epi8(v, _mm_add_epi8(_mm_shuffle_epi8(offsets, hi_nib), slash));
+
+    auto const pairs = _mm_maddubs_epi16(idx, _mm_set1_epi32(0x01400140));
+    auto const quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    auto const bytes = _mm_shuffle_epi8(quads, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(o), bytes);
+    return true;
+}
+#endif
+
+#if INTERNAL_KANGSW_BASE64_AVX2
+/** Encodes 24 bytes into 32 characters; reads 4 bytes before and after the input. */
+inline void _encode32(uint8_t const* in, char* o) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in - 4));
+    v         = _mm256_shuffle_epi8(v, _mm256_setr_epi8(5, 4, 6, 5, 8, 7, 9, 8, 11, 10, 12, 11, 14, 13, 15, 14, //
+                                                        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+    auto const hi  = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+    auto const lo  = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+    auto const idx = _mm256_or_si256(hi, lo);
+
+    auto range = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+    range      = _mm256_or_si256(range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx), _mm256_set1_epi8(13)));
+
+    auto const offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                                          'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    auto const chars   = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), idx);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(o), chars);
+}
+
+/** Decodes 32 characters into 24 bytes; writes 32 bytes. Returns false on invalid character. */
+inline bool _decode32(char const* in, uint8_t* o) {
+    auto const v      = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in));
+    auto const hi_nib = _mm256_and_si256(_mm256_srli_epi32(v, 4), _mm256_set1_epi8(0x0f));
+    auto const lo_nib = _mm256_and_si256(v, _mm256_set1_epi8(0x0f));
+
+    auto const valid_hi = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(char(0xa8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8),
+                    char(0xf8), char(0xf8), char(0xf8), char(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54));
+    auto const hi_bit  = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, char(0x80), 0, 0, 0, 0, 0, 0, 0, 0));
+    auto const matched = _mm256_and_si256(_mm256_shuffle_epi8(valid_hi, lo_nib), _mm256_shuffle_epi8(hi_bit, hi_nib));
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(matched, _mm256_setzero_si256())) != 0) { return false; }
+
+    auto const offsets = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0));
+    auto const slash   = _mm256_and_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')), _mm256_set1_epi8(16 - 19));
+    auto const idx     = _mm256_add_epi8(v, _mm256_add_epi8(_mm256_shuffle_epi8(offsets, hi_nib), slash));
+
+    auto const pairs = _mm256_maddubs_epi16(idx, _mm256_set1_epi32(0x01400140));
+    auto const quads = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    auto bytes       = _mm256_shuffle_epi8(quads, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, //
+                                                                   2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    bytes            = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(o), bytes);
+    return true;
+}
+#endif
+
+/**
+ * Encodes len bytes into output buffer, which must be able to hold encoded_size(len) characters.
+ *Returns end of written characters. Vectorized with AVX2 or SSSE3 if the target enables them.
+ */
+inline char* encode_to(void const* data, size_t len, char* o) noexcept {
+    auto in = static_cast<uint8_t const*>(data);
+
+#if INTERNAL_KANGSW_BASE64_AVX2
+    if (len >= 32) {
+        // the first block is encoded by narrower kernel, so that AVX2 kernel can load bytes before its input.
+        _encode16(in, o), in += 12, len -= 12, o += 16;
+        for (; len >= 28; in += 24, len -= 24, o += 32) { _encode32(in, o); }
     }
+#endif
+#if INTERNAL_KANGSW_BASE64_SSSE3
+    for (; len >= 16; in += 12, len -= 12, o += 16) { _encode16(in, o); }
+#endif
+
+    for (; len >= 3; in += 3, len -= 3, o += 4) { _encode_blk(o, in); }
 
     if (len) {
-        char in[3] = {};
-        char oblk[4];
-        for (size_t i = 0; i < len; ++i) { in[i] = *((char*)data + i); }
+        uint8_t tail[3] = {};
+        memcpy(tail, in, len);
+
+        char blk[4];
+        _encode_blk(blk, tail);
+        o[0] = blk[0], o[1] = blk[1];
+        o[2] = len == 2 ? blk[2] : _padchar;
+        o[3] = _padchar;
+        o += 4;
+    }
+    return o;
+}
+
+/** Returned by \ref decode_to on malformed input */
+constexpr size_t invalid = ~size_t{};
+
+/**
+ * Decodes padded base64 string into output buffer, which must be able to hold decoded_size(len)
+ *bytes. Returns number of written bytes, or \ref invalid if the string is not canonical base64;
+ *i.e. length is not multiple of 4, it contains character out of alphabet, padding appears other
+ *than at the end, or bits which are cut by padding are not zero.
+ */
+inline size_t decode_to(char const* in, size_t len, void* out) noexcept {
+    auto const begin = static_cast<uint8_t*>(out);
+    auto o           = begin;
+    if (len % 4 != 0) { return invalid; }
+
+    // vector kernels write more than they decode, thus leave enough output behind.
+#if INTERNAL_KANGSW_BASE64_AVX2
+    for (; len >= 48; in += 32, len -= 32, o += 24) {
+        if (!_decode32(in, o)) { return invalid; }
+    }
+#endif
+#if INTERNAL_KANGSW_BASE64_SSSE3
+    for (; len >= 24; in += 16, len -= 16, o += 12) {
+        if (!_decode16(in, o)) { return invalid; }
+    }
+#endif
+
+    for (; len > 4; in += 4, len -= 4, o += 3) {
+        auto const a = _table_decode[uint8_t(in[0])], b = _table_decode[uint8_t(in[1])];
+        auto const c = _table_decode[uint8_t(in[2])], d = _table_decode[uint8_t(in[3])];
+        if ((a | b | c | d) & 0x80) { return invalid; }
 
-        _encode_blk(oblk, in);
-        int n_pad = 3 - (int)len;
-        int n_ch  = 4 - n_pad;
+        uint32_t const v = uint32_t(a) << 18 | uint32_t(b) << 12 | uint32_t(c) << 6 | d;
+        o[0] = uint8_t(v >> 16), o[1] = uint8_t(v >> 8), o[2] = uint8_t(v);
+    }
+
+    if (len == 0) { return size_t(o - begin); }
+
+    // the last block may be padded.
+    int const num_pads = (in[3] == _padchar) + (in[3] == _padchar && in[2] == _padchar);
+    auto const a = _table_decode[uint8_t(in[0])], b = _table_decode[uint8_t(in[1])];
+    auto const c = num_pads < 2 ? _table_decode[uint8_t(in[2])] : uint8_t(0);
+    auto const d = num_pads < 1 ? _table_decode[uint8_t(in[3])] : uint8_t(0);
+    if ((a | b | c | d) & 0x80) { return invalid; }
+
+    uint32_t const v = uint32_t(a) << 18 | uint32_t(b) << 12 | uint32_t(c) << 6 | d;
+    if (num_pads == 2 && (v & 0xffff) != 0) { return invalid; }
+    if (num_pads == 1 && (v & 0xff) != 0) { return invalid; }
+
+    o[0] = uint8_t(v >> 16);
+    if (num_pads < 2) { o[1] = uint8_t(v >> 8); }
+    if (num_pads < 1) { o[2] = uint8_t(v); }
+    return size_t(o - begin) + 3 - num_pads;
+}
 
-        for (int i = 0; i < n_ch; ++i) { o = oblk[i]; }
-        for (int i = 0; i < n_pad; ++i) { o = _padchar; }
+/** Encodes into output iterator, through stack buffer of which blocks are encoded at once. */
+template <typename OutIt_>
+void encode(void const* data, size_t len, OutIt_&& o) {
+    constexpr size_t block = 3 * 256;
+    char buf[block / 3 * 4];
+
+    for (auto in = static_cast<uint8_t const*>(data); len > 0;) {
+        auto const n = std::min(len, block);
+        o            = std::copy(buf, encode_to(in, n, buf), o);
+        in += n, len -= n;
     }
 }
 
+/** Decodes into output iterator, as strict as \ref decode_to. Returns false on malformed input. */
 template <typename InIt_, typename OutIt_>
 bool decode(InIt_ start, InIt_ const end, OutIt_ o) {
-    // TODO: Է ͷ Ÿ InIt_ ׻ random_access_iterator Ͽ ȭϴ  ߰; if constexpr ͷ ˻ؼ ƾ и.   ʿ  ... (Ʈ Է  о )
     using ivalue_type = typename std::iterator_traits<InIt_>::value_type;
     using ovalue_type = typename OutIt_::container_type::value_type;
     static_assert(sizeof(ivalue_type) == 1);
     static_assert(sizeof(ovalue_type) == 1);
     static_assert(std::is_trivial_v<ovalue_type>);
 
-    for (auto it = start; it != end;) {
-        char iblk[4] = {};
-        int64_t oblk = 0;
-        int pad_pos  = 0;
-
-        for (; pad_pos < 4 && it != end; ++pad_pos, ++it) { iblk[pad_pos] = *it; }
-        for (pad_pos = 0; pad_pos < 4 && iblk[pad_pos] != '='; ++pad_pos) {}
-        if (pad_pos < 2) { return false; }
+    constexpr size_t block = 4 * 256;
+    char ibuf[block];
+    uint8_t obuf[block / 4 * 3];
 
-        for (int i = 0; i < pad_pos; ++i) {
-            auto bitval = _table_decode[iblk[i]];
-            if (bitval == 0xcc) { return false; }
-            oblk |= bitval << (3 - i) * 6;
-        }
+    for (auto it = start; it != end;) {
+        size_t n = 0;
+        for (; n < block && it != end; ++n, ++it) { ibuf[n] = char(*it); }
 
-        auto& chset = reinterpret_cast<std::array<const char, 3>&>(oblk);
-        int n_bin   = (pad_pos == 4) ? 3 : (pad_pos == 3) ? 2 : 1;
+        auto const num_decoded = decode_to(ibuf, n, obuf);
+        if (num_decoded == invalid) { return false; }
+        if (num_decoded != n / 4 * 3 && it != end) { return false; } // padding before the end
 
-        for (int i = 0; i < n_bin; ++i) { o = static_cast<ovalue_type>(chset[2 - i]); }
+        for (size_t i = 0; i < num_decoded; ++i) { o = static_cast<ovalue_type>(obuf[i]); }
     }
 
     return true;
@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+/*
+ * Z85 alphabet, which needs no escape in JSON strings; it contains '&', '<' and '>', thus must be
+ *escaped in XML. Unlike Z85, input of any length is accepted; the last partial group of n bytes is
+ *written as n + 1 characters, as of RFC 1924 and git binary patches.
+ */
+namespace kangsw::base85 {
+
+inline size_t encoded_size(size_t binary_len) { return binary_len / 4 * 5 + (binary_len % 4 ? binary_len % 4 + 1 : 0); }
+inline size_t decoded_size(size_t string_len) { return string_len / 5 * 4 + (string_len % 5 ? string_len % 5 - 1 : 0); }
+
+constexpr char _table_encode[86] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ.-:+=^!/*?&<>()[]{}@%$#";
+
+/** Digit value of each character; 0xff for characters out of alphabet. */
+constexpr auto _table_decode = [] {
+    std::array<uint8_t, 256> table = {};
+    for (auto& v : table) { v = 0xff; }
+    for (uint8_t i = 0; i < 85; ++i) { table[uint8_t(_table_encode[i])] = i; }
+    return table;
+}();
+
+/** Returned by \ref decode_to on malformed input */
+constexpr size_t invalid = ~size_t{};
+
+inline void _encode_blk(char* o, uint32_t v) noexcept {
+    for (int i = 4; i >= 0; --i, v /= 85) { o[i] = _table_encode[v % 85]; }
+}
+
+/** Decodes 5 characters; returns value above 32 bits if any character is invalid or the group overflows. */
+inline uint64_t _decode_blk(char const* in) noexcept {
+    uint64_t v = 0, invalid_bits = 0;
+    for (int i = 0; i < 5; ++i) {
+        auto const d = _table_decode[uint8_t(in[i])];
+        v = v * 85 + d, invalid_bits |= d;
+    }
+    return invalid_bits & 0x80 ? ~uint64_t{} : v;
+}
+
+/**
+ * Encodes len bytes into output buffer, which must be able to hold encoded_size(len) characters.
+ *Returns end of written characters.
+ */
+inline char* encode_to(void const* data, size_t len, char* o) noexcept {
+    auto in = static_cast<uint8_t const*>(data);
+    for (; len >= 4; in += 4, len -= 4, o += 5) {
+        _encode_blk(o, uint32_t(in[0]) << 24 | uint32_t(in[1]) << 16 | uint32_t(in[2]) << 8 | in[3]);
+    }
+
+    if (len) {
+        uint8_t tail[4] = {};
+        memcpy(tail, in, len);
+
+        char blk[5];
+        _encode_blk(blk, uint32_t(tail[0]) << 24 | uint32_t(tail[1]) << 16 | uint32_t(tail[2]) << 8 | tail[3]);
+        memcpy(o, blk, len + 1), o += len + 1;
+    }
+    return o;
+}
+
+/**
+ * Decodes string into output buffer, which must be able to hold decoded_size(len) bytes. Returns
+ *number of written bytes, or \ref invalid if the string contains character out of alphabet, any
+ *group exceeds 32 bits, or the last group has single character.
+ */
+inline size_t decode_to(char const* in, size_t len, void* out) noexcept {
+    if (len % 5 == 1) { return invalid; }
+
+    auto o = static_cast<uint8_t*>(out);
+    for (; len >= 5; in += 5, len -= 5, o += 4) {
+        auto const v = _decode_blk(in);
+        if (v > 0xffffffff) { return invalid; }
+        o[0] = uint8_t(v >> 24), o[1] = uint8_t(v >> 16), o[2] = uint8_t(v >> 8), o[3] = uint8_t(v);
+    }
+
+    if (len) {
+        // partial group is padded with the highest digit, which rounds truncated bits up.
+        char blk[5] = {'#', '#', '#', '#', '#'};
+        memcpy(blk, in, len);
+
+        auto const v = _decode_blk(blk);
+        if (v > 0xffffffff) { return invalid; }
+        for (size_t i = 0; i + 1 < len; ++i) { *o++ = uint8_t(v >> (24 - 8 * i)); }
+    }
+    return size_t(o - static_cast<uint8_t*>(out));
+}
+
+} // namespace kangsw::base85
@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace kangsw::hex {
+
+inline size_t encoded_size(size_t binary_len) { return binary_len * 2; }
+inline size_t decoded_size(size_t string_len) { return string_len / 2; }
+
+constexpr char _digits[17] = "0123456789abcdef";
+
+/** Two lowercase digits of each byte */
+constexpr auto _table_encode = [] {
+    std::array<char, 512> table = {};
+    for (size_t i = 0; i < 256; ++i) { table[i * 2] = _digits[i >> 4], table[i * 2 + 1] = _digits[i & 0xf]; }
+    return table;
+}();
+
+/** Value of each digit of either case; 0xff for non-digits */
+constexpr auto _table_decode = [] {
+    std::array<uint8_t, 256> table = {};
+    for (auto& v : table) { v = 0xff; }
+    for (uint8_t i = 0; i < 16; ++i) { table[uint8_t(_digits[i])] = i; }
+    for (uint8_t i = 10; i < 16; ++i) { table[uint8_t('A' + i - 10)] = i; }
+    return table;
+}();
+
+/** Returned by \ref decode_to on malformed input */
+constexpr size_t invalid = ~size_t{};
+
+/**
+ * Encodes len bytes into lowercase hexadecimal digits. Output buffer must be able to hold
+ *encoded_size(len) characters. Returns end of written characters.
+ */
+inline char* encode_to(void const* data, size_t len, char* o) noexcept {
+    auto in = static_cast<uint8_t const*>(data);
+    for (size_t i = 0; i < len; ++i, o += 2) { memcpy(o, &_table_encode[in[i] * 2], 2); }
+    return o;
+}
+
+/**
+ * Decodes hexadecimal digits of either case. Returns number of written bytes, or \ref invalid if
+ *length is odd or it contains non-digit character.
+ */
+inline size_t decode_to(char const* in, size_t len, void* out) noexcept {
+    if (len % 2 != 0) { return invalid; }
+
+    auto o = static_cast<uint8_t*>(out);
+    for (size_t i = 0; i < len; i += 2) {
+        auto const hi = _table_decode[uint8_t(in[i])], lo = _table_decode[uint8_t(in[i + 1])];
+        if ((hi | lo) & 0x80) { return invalid; }
+        *o++ = uint8_t(hi << 4 | lo);
+    }
+    return len / 2;
+}
+
+} // namespace kangsw::hex
@@ -0,0 +1,108 @@
+#pragma once
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace kangsw {
+
+/**
+ * Read-only mapping of whole file, which is hinted to be read sequentially.
+ *
+ * Throws std::system_error if file can't be opened or mapped. Empty files are not mapped, and
+ *yield empty view.
+ */
+class mapped_file {
+public:
+    explicit mapped_file(std::filesystem::path const& path) {
+#if _WIN32
+        auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) { _throw_last_error("CreateFile"); }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) { CloseHandle(file), _throw_last_error("GetFileSizeEx"); }
+
+        if ((_size = size_t(size.QuadPart)) > 0) {
+            auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping == nullptr) { CloseHandle(file), _throw_last_error("CreateFileMapping"); }
+
+            _data = static_cast<char const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping);
+            if (_data == nullptr) { CloseHandle(file), _throw_last_error("MapViewOfFile"); }
+        }
+        CloseHandle(file);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { _throw_errno("open"); }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) { ::close(fd), _throw_errno("fstat"); }
+
+        if ((_size = size_t(st.st_size)) > 0) {
+            auto p = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) { ::close(fd), _throw_errno("mmap"); }
+
+            _data = static_cast<char const*>(p);
+            ::madvise(p, _size, MADV_SEQUENTIAL);
+        }
+        ::close(fd); // mapping stays valid after descriptor is closed
+#endif
+    }
+
+    mapped_file(mapped_file&& other) noexcept
+      : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0)) {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        if (this != &other) {
+            _unmap();
+            _data = std::exchange(other._data, nullptr), _size = std::exchange(other._size, 0);
+        }
+        return *this;
+    }
+
+    ~mapped_file() { _unmap(); }
+
+public:
+    std::string_view view() const noexcept { return {_data, _size}; }
+    size_t size() const noexcept { return _size; }
+
+private:
+    void _unmap() noexcept {
+        if (_data == nullptr) { return; }
+#if _WIN32
+        UnmapViewOfFile(_data);
+#else
+        ::munmap(const_cast<char*>(_data), _size);
+#endif
+        _data = nullptr, _size = 0;
+    }
+
+#if _WIN32
+    [[noreturn]] static void _throw_last_error(char const* what) {
+        throw std::system_error{int(GetLastError()), std::system_category(), what};
+    }
+#else
+    [[noreturn]] static void _throw_errno(char const* what) {
+        throw std::system_error{errno, std::generic_category(), what};
+    }
+#endif
+
+private:
+    char const* _data = nullptr;
+    size_t _size      = 0;
+};
+
+} // namespace kangsw
@@ -0,0 +1,127 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+namespace kangsw {
+
+/** Non-owning view of single row of nested_vector */
+template <typename It_>
+class row_view {
+public:
+    using value_type = typename std::iterator_traits<It_>::value_type;
+
+public:
+    row_view(It_ first, It_ last) : _first(first), _last(last) {}
+
+    size_t size() const { return _last - _first; }
+    bool empty() const { return _first == _last; }
+
+    It_ begin() const { return _first; }
+    It_ end() const { return _last; }
+
+    decltype(auto) operator[](size_t i) const { return assert(i < size()), _first[i]; }
+
+    template <typename Range_>
+    bool operator==(Range_ const& r) const { return std::equal(begin(), end(), std::begin(r), std::end(r)); }
+
+private:
+    It_ _first, _last;
+};
+
+/**
+ * Array of arrays, stored in compressed sparse row(CSR) layout.
+ *
+ * Every row shares single value buffer, and rows are delimited by offsets buffer of which
+ *size is always number of rows + 1. Thus appending rows never allocates per row, and all
+ *elements stay contiguous in row order.
+ */
+template <typename Ty_>
+class nested_vector {
+public:
+    using value_type     = Ty_;
+    using values_type    = std::vector<Ty_>;
+    using offsets_type   = std::vector<size_t>;
+    using size_type      = size_t;
+    using iterator       = typename values_type::iterator;
+    using const_iterator = typename values_type::const_iterator;
+
+    using row       = row_view<iterator>;
+    using const_row = row_view<const_iterator>;
+
+public:
+    nested_vector() = default;
+
+    nested_vector(std::initializer_list<std::initializer_list<Ty_>> rows) {
+        for (auto& r : rows) { push_back(r.begin(), r.end()); }
+    }
+
+public:
+    /** Number of rows */
+    size_t size() const noexcept { return _offsets.size() - 1; }
+    bool empty() const noexcept { return size() == 0; }
+
+    /** Number of elements of all rows */
+    size_t num_values() const noexcept { return _values.size(); }
+
+    row operator[](size_t i) { return assert(i < size()), row{_values.begin() + _offsets[i], _values.begin() + _offsets[i + 1]}; }
+    const_row operator[](size_t i) const { return assert(i < size()), const_row{_values.begin() + _offsets[i], _values.begin() + _offsets[i + 1]}; }
+
+    row back() { return (*this)[size() - 1]; }
+    const_row back() const { return (*this)[size() - 1]; }
+
+    values_type const& values() const noexcept { return _values; }
+    offsets_type const& offsets() const noexcept { return _offsets; }
+
+public:
+    void reserve(size_t num_rows, size_t num_values) {
+        _offsets.reserve(num_rows + 1);
+        _values.reserve(num_values);
+    }
+
+    /** Appends new empty row. Use append() to fill it. */
+    void emplace_back() { _offsets.push_back(_values.size()); }
+
+    template <typename It_>
+    void push_back(It_ first, It_ last) {
+        _values.insert(_values.end(), first, last);
+        _offsets.push_back(_values.size());
+    }
+
+    template <typename Range_>
+    void push_back(Range_ const& r) { push_back(std::begin(r), std::end(r)); }
+
+    /** Appends an element to the last row */
+    void append(Ty_ v) {
+        assert(!empty());
+        _values.push_back(std::move(v));
+        ++_offsets.back();
+    }
+
+    /** Erases rows in range [from, to) */
+    void erase(size_t from, size_t to) {
+        assert(from <= to && to <= size());
+        auto const num_erased = _offsets[to] - _offsets[from];
+        _values.erase(_values.begin() + _offsets[from], _values.begin() + _offsets[to]);
+        _offsets.erase(_offsets.begin() + from + 1, _offsets.begin() + to + 1);
+
+        for (auto it = _offsets.begin() + from + 1; it != _offsets.end(); ++it) { *it -= num_erased; }
+    }
+
+    void clear() noexcept {
+        _values.clear();
+        _offsets.resize(1);
+    }
+
+    bool operator==(nested_vector const& r) const { return _offsets == r._offsets && _values == r._values; }
+    bool operator!=(nested_vector const& r) const { return !(*this == r); }
+
+private:
+    values_type _values;
+    offsets_type _offsets = {0};
+};
+
+} // namespace kangsw
@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace kangsw {
+
+/**
+ * Per-type cache of heap allocated instances, which keeps a free list per thread.
+ *
+ * Instances are recycled into the free list of the thread which released them, thus no
+ *synchronization is involved. Free instances are destroyed when their thread exits, or on
+ *release when the free list is already full.
+ */
+template <typename Ty_>
+class object_pool {
+public:
+    /** Pops free instance of calling thread. Returns nullptr if there's none. */
+    static Ty_* pop() noexcept {
+        if (_closed) { return nullptr; }
+
+        auto& items = _local().items;
+        if (items.empty()) { return nullptr; }
+
+        auto p = items.back().release();
+        items.pop_back();
+        return p;
+    }
+
+    /**
+     * Pushes instance into free list of calling thread, then takes its ownership.
+     * Returns false if free list is full; ownership stays in caller in that case.
+     */
+    static bool push(Ty_* p) noexcept {
+        if (_closed) { return false; }
+
+        auto& items = _local().items;
+        if (items.size() >= _capacity.load(std::memory_order_relaxed)) { return false; }
+
+        try {
+            items.emplace_back(p);
+        } catch (...) {
+            return false;
+        }
+        return true;
+    }
+
+    /** Number of free instances of calling thread */
+    static size_t num_free() noexcept { return _closed ? 0 : _local().items.size(); }
+
+    /** Destroys every free instance of calling thread */
+    static void trim() noexcept {
+        if (!_closed) { _local().items.clear(); }
+    }
+
+    /** Maximum number of free instances which each thread keeps. */
+    static size_t capacity() noexcept { return _capacity.load(std::memory_order_relaxed); }
+    static void capacity(size_t n) noexcept { _capacity.store(n, std::memory_order_relaxed); }
+
+private:
+    struct _free_list {
+        std::vector<std::unique_ptr<Ty_>> items;
+        ~_free_list() { _closed = true; }
+    };
+
+    static _free_list& _local() {
+        thread_local _free_list list;
+        return list;
+    }
+
+private:
+    // instances may be released during thread teardown, after the free list is destroyed.
+    static inline thread_local bool _closed = false;
+    static inline std::atomic<size_t> _capacity{64};
+};
+
+} // namespace kangsw
@@ -0,0 +1,210 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace kangsw {
+
+/**
+ * Extent-agnostic part of small_vector.
+ *
+ * Every operation is implemented here, thus any small_vector<Ty_, N> can be manipulated without
+ *knowing its inline capacity N. Inline storage is always placed right after this header.
+ */
+template <typename Ty_>
+class small_vector_base {
+public:
+    using value_type      = Ty_;
+    using size_type       = size_t;
+    using reference       = Ty_&;
+    using const_reference = Ty_ const&;
+    using iterator        = Ty_*;
+    using const_iterator  = Ty_ const*;
+
+public:
+    size_t size() const noexcept { return _size; }
+    size_t capacity() const noexcept { return _capacity; }
+    bool empty() const noexcept { return _size == 0; }
+
+    /** Whether elements are stored in inline storage, without heap allocation */
+    bool is_inlined() const noexcept { return _data == _inline_storage(); }
+
+    Ty_* data() noexcept { return _data; }
+    Ty_ const* data() const noexcept { return _data; }
+
+    iterator begin() noexcept { return _data; }
+    iterator end() noexcept { return _data + _size; }
+    const_iterator begin() const noexcept { return _data; }
+    const_iterator end() const noexcept { return _data + _size; }
+
+    Ty_& operator[](size_t i) noexcept { return assert(i < _size), _data[i]; }
+    Ty_ const& operator[](size_t i) const noexcept { return assert(i < _size), _data[i]; }
+
+    Ty_& front() noexcept { return (*this)[0]; }
+    Ty_ const& front() const noexcept { return (*this)[0]; }
+    Ty_& back() noexcept { return (*this)[_size - 1]; }
+    Ty_ const& back() const noexcept { return (*this)[_size - 1]; }
+
+public:
+    void reserve(size_t n) {
+        if (n > _capacity) { _grow(n); }
+    }
+
+    template <typename... Args_>
+    Ty_& emplace_back(Args_&&... args) {
+        if (_size == _capacity) { _grow(_size + 1); }
+        auto p = new (_data + _size) Ty_(std::forward<Args_>(args)...);
+        return ++_size, *p;
+    }
+
+    void push_back(Ty_ const& v) { emplace_back(v); }
+    void push_back(Ty_&& v) { emplace_back(std::move(v)); }
+    void pop_back() noexcept { _data[--_size].~Ty_(); }
+
+    void resize(size_t n) { _resize(n, [](Ty_* p) { new (p) Ty_(); }); }
+    void resize(size_t n, Ty_ const& v) { _resize(n, [&v](Ty_* p) { new (p) Ty_(v); }); }
+
+    void clear() noexcept {
+        std::destroy(begin(), end());
+        _size = 0;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        auto const dst = begin() + (first - begin());
+        auto const src = begin() + (last - begin());
+        auto const new_end = std::move(src, end(), dst);
+        std::destroy(new_end, end());
+        _size = new_end - begin();
+        return dst;
+    }
+
+    iterator erase(const_iterator at) { return erase(at, at + 1); }
+
+    template <typename It_>
+    void assign(It_ first, It_ last) {
+        clear();
+        reserve(std::distance(first, last));
+        for (; first != last; ++first) { emplace_back(*first); }
+    }
+
+    bool operator==(small_vector_base const& r) const { return std::equal(begin(), end(), r.begin(), r.end()); }
+    bool operator!=(small_vector_base const& r) const { return !(*this == r); }
+
+protected:
+    explicit small_vector_base(size_t inline_capacity) noexcept
+      : _data(_inline_storage()), _capacity(inline_capacity), _inline_capacity(inline_capacity) {}
+
+    ~small_vector_base() {
+        clear();
+        if (!is_inlined()) { std::allocator<Ty_>{}.deallocate(_data, _capacity); }
+    }
+
+    small_vector_base(small_vector_base const&) = delete;
+    small_vector_base& operator=(small_vector_base const&) = delete;
+
+    /** Takes elements of other. Heap buffer is stolen, otherwise inline elements are moved one by one. */
+    void _move_from(small_vector_base&& other) {
+        if (other.is_inlined()) {
+            assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+            other.clear();
+            return;
+        }
+
+        clear();
+        if (!is_inlined()) { std::allocator<Ty_>{}.deallocate(_data, _capacity); }
+
+        _data     = other._data;
+        _size     = other._size;
+        _capacity = other._capacity;
+
+        other._data     = other._inline_storage();
+        other._size     = 0;
+        other._capacity = other._inline_capacity;
+    }
+
+private:
+    Ty_* _inline_storage() noexcept { return reinterpret_cast<Ty_*>(reinterpret_cast<char*>(this) + _inline_offset()); }
+    Ty_ const* _inline_storage() const noexcept { return const_cast<small_vector_base*>(this)->_inline_storage(); }
+
+    static constexpr size_t _inline_offset() noexcept {
+        return (sizeof(small_vector_base) + alignof(Ty_) - 1) / alignof(Ty_) * alignof(Ty_);
+    }
+
+    void _grow(size_t min_capacity) {
+        auto const new_capacity = std::max(min_capacity, _capacity * 2);
+        auto const new_data     = std::allocator<Ty_>{}.allocate(new_capacity);
+
+        std::uninitialized_move(begin(), end(), new_data);
+        std::destroy(begin(), end());
+        if (!is_inlined()) { std::allocator<Ty_>{}.deallocate(_data, _capacity); }
+
+        _data     = new_data;
+        _capacity = new_capacity;
+    }
+
+    template <typename Construct_>
+    void _resize(size_t n, Construct_&& construct) {
+        if (n < _size) {
+            std::destroy(begin() + n, end());
+        } else {
+            reserve(n);
+            for (auto p = end(); p != begin() + n; ++p) { construct(p); }
+        }
+        _size = n;
+    }
+
+private:
+    Ty_* _data;
+    size_t _size = 0;
+    size_t _capacity;
+    size_t _inline_capacity;
+};
+
+/**
+ * Vector with inline capacity of N_ elements.
+ *
+ * Does not allocate until its size exceeds N_, thus small arrays stay contiguous with owning
+ *object.
+ */
+template <typename Ty_, size_t N_>
+class small_vector : public small_vector_base<Ty_> {
+    static_assert(N_ > 0, "inline capacity must be greater than 0");
+    using base_type = small_vector_base<Ty_>;
+
+public:
+    static constexpr size_t inline_capacity = N_;
+
+public:
+    small_vector() noexcept : base_type(N_) { assert(static_cast<void*>(_storage) == this->data()); }
+    ~small_vector() = default;
+
+    small_vector(std::initializer_list<Ty_> il) : small_vector() { this->assign(il.begin(), il.end()); }
+
+    template <typename It_, typename = typename std::iterator_traits<It_>::iterator_category>
+    small_vector(It_ first, It_ last) : small_vector() { this->assign(first, last); }
+
+    small_vector(small_vector const& other) : small_vector() { this->assign(other.begin(), other.end()); }
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<Ty_>) : small_vector() { this->_move_from(std::move(other)); }
+
+    small_vector& operator=(small_vector const& other) {
+        if (this != &other) { this->assign(other.begin(), other.end()); }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<Ty_>) {
+        if (this != &other) { this->_move_from(std::move(other)); }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<Ty_> il) { return this->assign(il.begin(), il.end()), *this; }
+
+private:
+    alignas(Ty_) std::byte _storage[sizeof(Ty_) * N_];
+};
+
+} // namespace kangsw
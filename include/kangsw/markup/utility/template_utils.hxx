@@ -12,6 +12,15 @@ template <template <class...> class Template, class... Args>
 struct is_specialization_of<Template<Args...>, Template> : std::true_type {
 };
 
+/** is_specialization_of, for templates which take single type and size; e.g. std::array */
+template <class T, template <class, size_t> class Template>
+struct is_sized_specialization_of : std::false_type {
+};
+
+template <template <class, size_t> class Template, class Arg, size_t N>
+struct is_sized_specialization_of<Template<Arg, N>, Template> : std::true_type {
+};
+
 // https://stackoverflow.com/questions/60113615/how-to-check-if-a-variable-is-a-map-in-c
 template <typename T>
 struct is_map : std::false_type {};
@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kangsw {
+
+/**
+ * Fixed set of worker threads which run posted tasks in order of submission.
+ *
+ * Workers are joined on destruction, after every task which was posted until then is done.
+ */
+class thread_pool {
+public:
+    explicit thread_pool(size_t num_workers = std::thread::hardware_concurrency()) {
+        _workers.reserve(num_workers);
+        for (size_t i = 0; i < num_workers; ++i) { _workers.emplace_back([this] { _run(); }); }
+    }
+
+    thread_pool(thread_pool const&) = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard _{_lock};
+            _stopping = true;
+        }
+
+        _cv.notify_all();
+        for (auto& w : _workers) { w.join(); }
+    }
+
+public:
+    /** Number of worker threads */
+    size_t size() const noexcept { return _workers.size(); }
+
+    /** Queues task, which must not throw. */
+    void post(std::function<void()> task) {
+        {
+            std::lock_guard _{_lock};
+            _tasks.push_back(std::move(task));
+        }
+        _cv.notify_one();
+    }
+
+    /**
+     * Invokes fn(i) for every i in [0, n), on workers and calling thread together. Blocks until
+     *every invocation is done, then rethrows the first exception if any.
+     *
+     * Calling thread takes items as well, thus it is safe to call from a worker of same pool.
+     */
+    template <typename Fn_>
+    void parallel_for(size_t n, Fn_&& fn) {
+        if (n == 0) { return; }
+
+        struct batch {
+            std::atomic_size_t next = 0;
+            size_t num_done         = 0;
+            std::exception_ptr error;
+            std::mutex lock;
+            std::condition_variable cv;
+        };
+
+        // workers which start after the batch is drained never touch fn, which may be gone then.
+        auto b         = std::make_shared<batch>();
+        auto const run = [b, n, f = &fn] {
+            for (size_t i, num_done = 0;; ++num_done) {
+                if ((i = b->next.fetch_add(1)) >= n) {
+                    std::lock_guard _{b->lock};
+                    if ((b->num_done += num_done) == n) { b->cv.notify_all(); }
+                    return;
+                }
+
+                try {
+                    (*f)(i);
+                } catch (...) {
+                    std::lock_guard _{b->lock};
+                    if (!b->error) { b->error = std::current_exception(); }
+                }
+            }
+        };
+
+        for (size_t i = 0, num_tasks = std::min(size(), n - 1); i < num_tasks; ++i) { post(run); }
+        run();
+
+        std::unique_lock l{b->lock};
+        b->cv.wait(l, [&] { return b->num_done == n; });
+        if (b->error) { std::rethrow_exception(b->error); }
+    }
+
+private:
+    void _run() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock l{_lock};
+                _cv.wait(l, [this] { return _stopping || !_tasks.empty(); });
+                if (_tasks.empty()) { return; }
+
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+private:
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _lock;
+    std::condition_variable _cv;
+    bool _stopping = false;
+};
+
+} // namespace kangsw
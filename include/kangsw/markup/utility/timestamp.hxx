@@ -0,0 +1,228 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace kangsw::timestamp {
+
+struct civil_date {
+    int64_t year;
+    unsigned month; // [1, 12]
+    unsigned day;   // [1, 31]
+};
+
+/** Converts days since 1970-01-01 into proleptic Gregorian date, without any table or loop. */
+constexpr civil_date civil_from_days(int64_t days) noexcept {
+    days += 719468; // shifts epoch to 0000-03-01, thus leap day comes last in each year
+    int64_t const era  = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned const doe = unsigned(days - era * 146097);
+    unsigned const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned const mp  = (5 * doy + 2) / 153;
+    unsigned const d   = doy - (153 * mp + 2) / 5 + 1;
+    unsigned const m   = mp < 10 ? mp + 3 : mp - 9;
+    return {int64_t(yoe) + era * 400 + (m <= 2), m, d};
+}
+
+/** Converts proleptic Gregorian date into days since 1970-01-01; inverse of \ref civil_from_days. */
+constexpr int64_t days_from_civil(int64_t year, unsigned month, unsigned day) noexcept {
+    year -= month <= 2;
+    int64_t const era  = (year >= 0 ? year : year - 399) / 400;
+    unsigned const yoe = unsigned(year - era * 400);
+    unsigned const doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + int64_t(doe) - 719468;
+}
+
+constexpr unsigned days_in_month(int64_t year, unsigned month) noexcept {
+    if (month != 2) { return 30 + ((month + (month >> 3)) & 1); }
+    return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 29 : 28;
+}
+
+/** Length of the longest timestamp which \ref format writes. */
+constexpr size_t max_formatted_size = sizeof "-292277-12-31T23:59:59.999999999Z";
+
+namespace _internal {
+constexpr char _digit_pairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+inline char* _write2(char* o, unsigned v) noexcept { return memcpy(o, _digit_pairs + v * 2, 2), o + 2; }
+
+/** Date part of the day which was formatted last on this thread, which is shared by most of adjacent timestamps. */
+struct _date_prefix {
+    int64_t days = std::numeric_limits<int64_t>::min();
+    char str[max_formatted_size];
+    size_t size = 0;
+};
+
+inline _date_prefix& _cached_date(int64_t days) noexcept {
+    thread_local _date_prefix cache;
+    if (cache.days == days) { return cache; }
+
+    auto const date = civil_from_days(days);
+    auto o          = cache.str;
+    if (0 <= date.year && date.year <= 9999) {
+        o = _write2(_write2(o, unsigned(date.year / 100)), unsigned(date.year % 100));
+    } else {
+        o = std::to_chars(o, o + 8, date.year).ptr;
+    }
+    *o++ = '-', o = _write2(o, date.month);
+    *o++ = '-', o = _write2(o, date.day);
+    *o++ = 'T';
+
+    cache.days = days, cache.size = size_t(o - cache.str);
+    return cache;
+}
+/** Loads 8 characters, so that the first one is the lowest byte. */
+inline uint64_t _load8(char const* p) noexcept {
+    uint64_t v;
+    memcpy(&v, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+/**
+ * Validates 8 characters at once, where mask selects bytes which must be digits and the rest must
+ *equal to those of pattern. Returns digit values of each byte, or ~0 on mismatch.
+ */
+inline uint64_t _digits8(uint64_t v, uint64_t pattern, uint64_t mask) noexcept {
+    constexpr uint64_t ones = 0x0101010101010101;
+
+    auto const x = v ^ (ones * '0'); // digits become [0, 9], with zero upper nibble
+    bool const is_digit   = (((x & (ones * 0xf0)) | ((x + ones * 6) & (ones * 0xf0))) & mask) == 0;
+    bool const is_pattern = ((v ^ pattern) & ~mask) == 0;
+    return is_digit && is_pattern ? x & mask : ~uint64_t{};
+}
+
+/** Two digit number which begins at given byte of digit values */
+constexpr unsigned _pair(uint64_t digits, int byte) noexcept {
+    return unsigned(digits >> (byte * 8) & 0xff) * 10 + unsigned(digits >> (byte * 8 + 8) & 0xff);
+}
+
+constexpr bool _is_digit(char ch) noexcept { return '0' <= ch && ch <= '9'; }
+} // namespace _internal
+
+/**
+ * Writes time point as RFC 3339 UTC timestamp, i.e. "YYYY-MM-DDThh:mm:ss.SSSZ", with given number
+ *of fraction digits in [0, 9]; fraction is truncated. Returns end of written characters.
+ *
+ * Output buffer must be able to hold \ref max_formatted_size characters.
+ */
+template <typename Clock_, typename Duration_>
+char* format(char* o, std::chrono::time_point<Clock_, Duration_> t, int fraction_digits = 3) noexcept {
+    using namespace std::chrono;
+    auto const since_epoch = t.time_since_epoch();
+    auto const secs        = floor<seconds>(since_epoch);
+    auto const frac        = duration_cast<nanoseconds>(since_epoch - secs).count();
+
+    int64_t const s    = secs.count();
+    int64_t const days = (s >= 0 ? s : s - 86399) / 86400;
+    auto const sod     = unsigned(s - days * 86400);
+
+    auto& date = _internal::_cached_date(days);
+    o          = (memcpy(o, date.str, date.size), o + date.size);
+
+    o    = _internal::_write2(o, sod / 3600);
+    *o++ = ':', o = _internal::_write2(o, sod / 60 % 60);
+    *o++ = ':', o = _internal::_write2(o, sod % 60);
+
+    if (fraction_digits > 0) {
+        fraction_digits = std::min(fraction_digits, 9);
+        *o++            = '.';
+
+        auto v = unsigned(frac);
+        for (int i = fraction_digits; i < 9; ++i) { v /= 10; }
+        for (int i = fraction_digits - 1; i >= 0; --i, v /= 10) { o[i] = char('0' + v % 10); }
+        o += fraction_digits;
+    }
+
+    *o++ = 'Z';
+    return o;
+}
+
+/**
+ * Parses RFC 3339 timestamp, i.e. "YYYY-MM-DDThh:mm:ss[.fraction](Z|+hh:mm|-hh:mm)", into time
+ *point. Fraction may have any number of digits, of which ones below nanoseconds are truncated.
+ *
+ * Input is never read past end. Returns end of parsed characters, or nullptr if input is
+ *malformed, in which case output is left untouched.
+ */
+template <typename Clock_, typename Duration_>
+char const* parse(char const* begin, char const* end, std::chrono::time_point<Clock_, Duration_>& out) noexcept {
+    using namespace std::chrono;
+    using _internal::_pair;
+    constexpr size_t min_length = sizeof "YYYY-MM-DDThh:mm:ssZ" - 1;
+    if (end - begin < ptrdiff_t(min_length)) { return nullptr; }
+
+    // date and time separator may be 't' or space as well, which is normalized before matching.
+    auto const t = begin[10];
+    if (t != 'T' && t != 't' && t != ' ') { return nullptr; }
+    auto const time_chars = (_internal::_load8(begin + 8) & ~(uint64_t{0xff} << 16)) | (uint64_t{'T'} << 16);
+
+    // clang-format off
+    auto const date = _internal::_digits8(_internal::_load8(begin), 0x2d'00'00'2d'00'00'00'00, 0x00'ff'ff'00'ff'ff'ff'ff); // YYYY-MM-
+    auto const time = _internal::_digits8(time_chars, 0x00'00'3a'00'00'54'00'00, 0xff'ff'00'ff'ff'00'ff'ff);             // DDThh:mm
+    // clang-format on
+    if (date == ~uint64_t{} || time == ~uint64_t{}) { return nullptr; }
+    if (begin[16] != ':' || !_internal::_is_digit(begin[17]) || !_internal::_is_digit(begin[18])) { return nullptr; }
+
+    int64_t const year   = _pair(date, 0) * 100 + _pair(date, 2);
+    unsigned const month = _pair(date, 5), day = _pair(time, 0);
+    unsigned const hour = _pair(time, 3), minute = _pair(time, 6);
+    unsigned const second = unsigned(begin[17] - '0') * 10 + unsigned(begin[18] - '0');
+
+    if (month - 1 >= 12 || day - 1 >= days_in_month(year, month)) { return nullptr; }
+    if (hour > 23 || minute > 59 || second > 60) { return nullptr; } // leap second rolls into next minute
+
+    auto p        = begin + 19;
+    int64_t nanos = 0;
+    if (*p == '.') {
+        auto const digits = ++p;
+        for (; p != end && _internal::_is_digit(*p); ++p) {
+            if (p - digits < 9) { nanos = nanos * 10 + (*p - '0'); }
+        }
+        if (p == digits) { return nullptr; }
+        for (auto n = p - digits; n < 9; ++n) { nanos *= 10; }
+        if (p == end) { return nullptr; }
+    }
+
+    int64_t offset = 0;
+    if (*p == 'Z' || *p == 'z') {
+        ++p;
+    } else if (*p == '+' || *p == '-') {
+        if (end - p < 6 || p[3] != ':') { return nullptr; }
+        for (int i : {1, 2, 4, 5}) {
+            if (!_internal::_is_digit(p[i])) { return nullptr; }
+        }
+
+        unsigned const oh = unsigned(p[1] - '0') * 10 + unsigned(p[2] - '0');
+        unsigned const om = unsigned(p[4] - '0') * 10 + unsigned(p[5] - '0');
+        if (oh > 23 || om > 59) { return nullptr; }
+
+        offset = (*p == '+' ? 1 : -1) * int64_t(oh * 3600 + om * 60);
+        p += 6;
+    } else {
+        return nullptr;
+    }
+
+    int64_t const secs = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+    out                = time_point<Clock_, Duration_>{duration_cast<Duration_>(seconds{secs})
+                                                       + duration_cast<Duration_>(nanoseconds{nanos})};
+    return p;
+}
+
+} // namespace kangsw::timestamp
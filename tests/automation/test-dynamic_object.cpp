@@ -0,0 +1,83 @@
+#include "doctest.h"
+#include "kangsw/markup/marshal/json.hxx"
+#include "kangsw/markup/reflection/compare.hxx"
+#include "kangsw/markup/reflection/dynamic_object.hpp"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+TEST_SUITE("Types.Dynamic Object") {
+    TEST_CASE("Shape sharing") {
+        refl::dynamic_object a, b;
+        CHECK(&a.shape() == &refl::dynamic_shape::root());
+
+        a.add("id", 3);
+        a.add("name", "first");
+        b.add("id", 4);
+        b.add("name", "second");
+
+        // same properties added in same order end up in single shape.
+        CHECK(&a.traits() == &b.traits());
+        CHECK(a.shape().parent()->parent() == &refl::dynamic_shape::root());
+        CHECK(a.at<int32_t>("id") == 3);
+        CHECK(b.at<refl::u8str>("name") == "second");
+
+        // type of property is part of shape.
+        refl::dynamic_object c;
+        c.add("id", 3.5);
+        CHECK(&c.shape() != &a.shape().parent()->parent()->with<int32_t>("id"));
+        CHECK(&a.shape().parent()->parent()->with<int32_t>("id") == a.shape().parent());
+
+        CHECK(a.find<double>("nothing") == nullptr);
+        CHECK_THROWS_AS(a.find<double>("id"), refl::property_type_mismatch_exception);
+        CHECK_THROWS_AS(a.add<double>("id"), refl::property_type_mismatch_exception);
+    }
+
+    TEST_CASE("Buffer growth, copy and move") {
+        refl::dynamic_object a;
+        for (int i = 0; i < 20; ++i) {
+            a.add("s" + std::to_string(i), std::string(i * 4, 'x'));
+        }
+        for (int i = 0; i < 20; ++i) {
+            REQUIRE(a.at<refl::u8str>("s" + std::to_string(i)).size() == i * 4);
+        }
+
+        auto b = a;
+        CHECK(&b.shape() == &a.shape());
+        CHECK(refl::equal(a, b));
+
+        b.at<refl::u8str>("s3") = "changed";
+        CHECK(!refl::equal(a, b));
+
+        auto c = std::move(b);
+        CHECK(c.at<refl::u8str>("s3") == "changed");
+        CHECK(&b.shape() == &refl::dynamic_shape::root());
+
+        refl::dynamic_object small;
+        small.add("v", 1);
+        auto d = std::move(small);
+        CHECK(d.at<int32_t>("v") == 1);
+    }
+
+    TEST_CASE("Reflection of dynamic object") {
+        refl::dynamic_object a;
+        a.add("rev", 3);
+        a.add("values", std::vector({1.5, 2.5}));
+        a.add("tags", std::vector({"x", "y"}));
+
+        refl::u8str s;
+        marshal::json_dump{}(a, {s});
+        CHECK(s == R"({"rev": 3,"values": [1.5, 2.5],"tags": ["x", "y"]})");
+
+        auto o = a.shape().acquire_object();
+        CHECK(&o->traits() == &a.traits());
+        CHECK(static_cast<refl::dynamic_object&>(*o).at<int32_t>("rev") == 0);
+
+        marshal::json_parse{}(s, *o);
+        CHECK(refl::equal(a, *o));
+
+        a.reset();
+        CHECK(a.at<int32_t>("rev") == 0);
+        CHECK(a.at<std::vector<refl::u8str>>("tags").empty());
+    }
+}
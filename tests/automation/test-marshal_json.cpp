@@ -1,5 +1,15 @@
 #include "doctest.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+#if !_WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 #include "kangsw/markup/marshal/json.hxx"
+#include "kangsw/markup/reflection/property_path.hxx"
 #include "test_type.hxx"
 #include <conio.h>
 
@@ -55,6 +65,14 @@ TEST_SUITE("Marshal.Json") {
 
         CPPMARKUP_ELEMENT(v6_some_float, 2.0);
         CPPMARKUP_ELEMENT(v7_some_binary, kangsw::refl::binary_chunk::from(3, 4, 1));
+        CPPMARKUP_ELEMENT(v8_narrow_array, std::vector<uint8_t>({1, 141, 255}));
+        CPPMARKUP_ELEMENT(v9_float_array, std::vector({1.5f, -0.25f, 3.125f}));
+        CPPMARKUP_ELEMENT(v10_short, int16_t(-1024));
+        CPPMARKUP_ELEMENT(v11_packed_flags, kangsw::refl::bit_vector({true, false, false, true, true}));
+        CPPMARKUP_ELEMENT(v12_fixed_vector, (std::array<float, 3>({1.f, 2.f, 3.f})));
+        CPPMARKUP_ELEMENT(v13_inlined_ints, (kangsw::small_vector<int32_t, 4>({4, 5, 6})));
+        CPPMARKUP_ELEMENT(v14_matrix, (kangsw::nested_vector<double>({{1., 2.}, {}, {3.5}})));
+        CPPMARKUP_ELEMENT(v15_tag_rows, (kangsw::nested_vector<refl::u8str>({{"a"}, {"b", "c"}})));
     };
 
     TEST_CASE("Parse") {
@@ -103,6 +121,794 @@ TEST_SUITE("Marshal.Json") {
               dest.v3_inner_obj.v5_timestamp.time_since_epoch().count() / 1'000'000 == test.v3_inner_obj.v5_timestamp.time_since_epoch().count() / 1'000'000);
             CHECK(dest.v6_some_float == test.v6_some_float);
             CHECK(dest.v7_some_binary == test.v7_some_binary);
+            CHECK(dest.v8_narrow_array == test.v8_narrow_array);
+            CHECK(dest.v9_float_array == test.v9_float_array);
+            CHECK(dest.v10_short == test.v10_short);
+            CHECK(dest.v11_packed_flags == test.v11_packed_flags);
+            CHECK(dest.v12_fixed_vector == test.v12_fixed_vector);
+            CHECK(dest.v13_inlined_ints == test.v13_inlined_ints);
+            CHECK(dest.v14_matrix == test.v14_matrix);
+            CHECK(dest.v15_tag_rows == test.v15_tag_rows);
         }
+
+        SUBCASE("Fixed array rejects excess elements") {
+            parsetest dest = {};
+            str = R"({"v12_fixed_vector": [1.0, 2.0, 3.0, 4.0]})";
+            CHECK(marshal::json_parse{}(str, dest).has_value());
+        }
+
+        SUBCASE("Fixed array is replaced wholesale in merge mode") {
+            parsetest dest;
+            dest.reset();
+            str = R"({"v12_fixed_vector": [7.0]})";
+            REQUIRE(marshal::json_parse{true}(str, dest).has_value() == false);
+            CHECK(dest.v12_fixed_vector == std::array<float, 3>{7.f, 0.f, 0.f});
+            CHECK(dest.v1_int == test.v1_int);
+        }
+
+        SUBCASE("Narrow numeric properties keep declared width") {
+            static_assert(std::is_same_v<decltype(test.v1_int), int32_t>);
+            static_assert(std::is_same_v<decltype(test.v8_narrow_array), std::vector<uint8_t>>);
+            static_assert(std::is_same_v<decltype(test.v9_float_array), std::vector<float>>);
+
+            auto prop = test.traits().find_property("v10_short");
+            REQUIRE(prop);
+            CHECK(prop->memory().size == sizeof(int16_t));
+            CHECK(prop->memory().subtype == refl::esubtype::i16);
+            CHECK_THROWS_AS(refl::make_proxy<refl::integer_t>(test.base(), *prop), refl::property_type_mismatch_exception);
+            CHECK(*refl::make_proxy<int16_t>(test.base(), *prop) == -1024);
+        }
+    }
+
+    CPPMARKUP_OBJECT_TEMPLATE(tracked) {
+        CPPMARKUP_TRACK_CHANGES()
+
+        CPPMARKUP_ELEMENT(counter, 1);
+        CPPMARKUP_ELEMENT(title, "text");
+        CPPMARKUP_ELEMENT(samples, std::vector({1.5, 2.5}));
+
+        CPPMARKUP_EMBED_OBJECT_begin(inner) //
+        {
+            CPPMARKUP_TRACK_CHANGES()
+            CPPMARKUP_ELEMENT(ratio, 0.5);
+        }
+        CPPMARKUP_EMBED_OBJECT_end(inner);
+    };
+
+    TEST_CASE("Dirty tracking and cached fragments") {
+        auto obj = tracked::get_default();
+        REQUIRE(obj.state());
+        CHECK(obj.state()->any_dirty() == false);
+        CHECK(parsetest::get_default().state() == nullptr);
+
+        auto const dump = [](tracked const& o, bool reuse) {
+            refl::u8str s;
+            marshal::json_dump{reuse}(o, {s, 2});
+            return s;
+        };
+
+        auto const fresh = dump(obj, true);
+        CHECK(fresh == dump(obj, false));
+        CHECK(dump(obj, true) == fresh);
+
+        auto& counter_prop = *obj.traits().find_property("counter");
+        *refl::make_proxy<int32_t>(obj.base(), counter_prop) = 42;
+        CHECK(obj.state()->is_dirty(&counter_prop - obj.properties().data()));
+        CHECK(dump(obj, true) == dump(obj, false));
+        CHECK(dump(obj, true).find("42") != refl::u8str::npos);
+
+        // direct member writes bypass tracking, until marked manually.
+        obj.title = "changed";
+        CHECK(dump(obj, true).find("changed") == refl::u8str::npos);
+        refl::mark_dirty(obj, *obj.traits().find_property("title"));
+        CHECK(dump(obj, true) == dump(obj, false));
+
+        // embedded objects are tracked by their own states.
+        refl::u8str patch = R"({"inner": {"ratio": 0.25}})";
+        obj.state()->clear_dirty();
+        REQUIRE(marshal::json_parse{true}(patch, obj).has_value() == false);
+        CHECK(obj.inner.state()->any_dirty());
+        CHECK(dump(obj, true) == dump(obj, false));
+        CHECK(dump(obj, true).find("0.25") != refl::u8str::npos);
+
+        // reading through non-const proxy keeps cached fragments.
+        auto& samples_prop = *obj.traits().find_property("samples");
+        auto const samples = &samples_prop - obj.properties().data();
+        auto samples_proxy = refl::make_proxy<std::vector<double>>(obj.base(), samples_prop);
+        obj.state()->clear_dirty();
+        CHECK(samples_proxy.size() == 2);
+        CHECK(std::as_const(samples_proxy)[1] == 2.5);
+        CHECK(obj.state()->is_dirty(samples) == false);
+        samples_proxy[1] = 3.5;
+        CHECK(obj.state()->is_dirty(samples));
+        CHECK(dump(obj, true) == dump(obj, false));
+
+        // unmodified embedded object is copied as a whole, until it is modified.
+        auto const cached = dump(obj, true);
+        obj.inner.ratio   = 0.75;
+        CHECK(dump(obj, true) == cached);
+        *refl::make_proxy<double>(obj.inner.base(), *obj.inner.traits().find_property("ratio")) = 0.125;
+        CHECK(dump(obj, true) == dump(obj, false));
+        CHECK(dump(obj, true).find("0.125") != refl::u8str::npos);
+
+        // cached fragments are shared by concurrent dumps.
+        obj.state()->invalidate();
+        refl::u8str results[4];
+        std::vector<std::thread> threads;
+        for (auto& result : results) {
+            threads.emplace_back([&] { result = dump(obj, true); });
+        }
+        for (auto& thread : threads) { thread.join(); }
+        for (auto& result : results) { CHECK(result == dump(obj, false)); }
+    }
+
+    TEST_CASE("Projection parsing") {
+        auto src = my_markup_type::get_default();
+        src.rev_minor             = 42;
+        src.some_dbl              = 1.25;
+        src.list_author           = {"only", "this"};
+        src.some_obj_arr_.encrypt = refl::binary_chunk::from(7, 8, 9);
+
+        refl::u8str s;
+        marshal::json_dump{}(src, {s});
+
+        marshal::json_projection proj{my_markup_type::traits_type::get(), {"/rev_minor", "/some_obj_arr"}};
+        auto dst = my_markup_type::get_default();
+        dst.list_author.clear();
+        REQUIRE(marshal::json_parse{}(s, dst, proj).has_value() == false);
+        CHECK(dst.rev_minor == 42);
+        CHECK(dst.some_dbl == my_markup_type::get_default().some_dbl);
+        CHECK(dst.list_author.empty());
+
+        // attributes follow their owner.
+        CHECK(dst.some_obj_arr_.encrypt == src.some_obj_arr_.encrypt);
+
+        auto obj = tracked::get_default();
+        marshal::json_projection inner_only{obj.traits(), {"/inner/ratio"}};
+        REQUIRE(marshal::json_parse{}(R"({"counter": 5, "inner": {"ratio": 0.25}})", obj, inner_only).has_value() == false);
+        CHECK(obj.counter == 1);
+        CHECK(obj.inner.ratio == 0.25);
+
+        CHECK_THROWS_AS((marshal::json_projection{obj.traits(), {"/counter/x"}}), refl::invalid_property_path_exception);
+        CHECK_THROWS_AS((marshal::json_projection{obj.traits(), {"/nothing"}}), refl::invalid_property_path_exception);
+        CHECK_THROWS_AS(marshal::json_parse{}(s, obj, proj), std::invalid_argument);
+    }
+
+    TEST_CASE("Deferred nested values") {
+        auto obj            = tracked::get_default();
+        auto& samples_prop  = *obj.traits().find_property("samples");
+        auto const samples  = &samples_prop - obj.properties().data();
+        refl::u8str const s = R"({"counter": 5, "samples": [ 3.5,4.5 ], "inner": {"ratio": 0.25}})";
+
+        REQUIRE(marshal::json_parse{}.defer_nested()(s, obj).has_value() == false);
+        CHECK(obj.counter == 5);
+        REQUIRE(obj.state()->deferred(samples));
+        CHECK(*obj.state()->deferred(samples) == "[ 3.5,4.5 ]");
+        CHECK(obj.samples.size() == 2); // not parsed yet
+
+        // untouched values are forwarded as received.
+        refl::u8str dump;
+        marshal::json_dump{}(obj, {dump});
+        CHECK(dump.find("[ 3.5,4.5 ]") != refl::u8str::npos);
+
+        // first access through reflection parses, without making it dirty.
+        obj.state()->clear_dirty();
+        auto const& cobj = obj;
+        CHECK(refl::make_proxy<std::vector<double>>(cobj.base(), samples_prop)->at(0) == 3.5);
+        CHECK(obj.state()->deferred(samples) == nullptr);
+        CHECK(obj.state()->any_dirty() == false);
+
+        refl::materialize(obj);
+        CHECK(obj.state()->any_deferred() == false);
+        CHECK(obj.inner.ratio == 0.25);
+
+        // malformed values are reported on access.
+        REQUIRE(marshal::json_parse{}.defer_nested()(R"({"inner": {"ratio": [1]}})", obj).has_value() == false);
+        CHECK_THROWS_AS(refl::materialize(obj), refl::deferred_parse_exception);
+
+        REQUIRE(marshal::json_parse{}.defer_nested()(s, obj).has_value() == false);
+        obj.reset();
+        CHECK(obj.state()->any_deferred() == false);
+        CHECK(obj.samples == std::vector({1.5, 2.5}));
+    }
+
+    TEST_CASE("Deferred values through reflection algorithms") {
+        refl::u8str const s = R"({"counter": 5, "samples": [3.5, 4.5], "inner": {"ratio": 0.25}})";
+        auto const defer    = [&](tracked& o) {
+            REQUIRE(marshal::json_parse{}.defer_nested()(s, o).has_value() == false);
+            REQUIRE(o.state()->any_deferred());
+        };
+
+        auto eager = tracked::get_default();
+        REQUIRE(marshal::json_parse{}(s, eager).has_value() == false);
+
+        auto a = tracked::get_default(), b = tracked::get_default();
+        defer(a), defer(b);
+        CHECK(refl::equal(eager, a));
+        CHECK(refl::compare(b, eager) == 0);
+
+        auto c = tracked::get_default(), d = tracked::get_default();
+        defer(c), defer(d);
+        refl::u8str patch;
+        CHECK(marshal::json_diff{}(c, eager, {patch}) == false);
+        patch.clear();
+        CHECK(marshal::json_diff{}(tracked::get_default(), d, {patch}));
+        CHECK(patch.find("0.25") != refl::u8str::npos);
+        CHECK(patch.find("4.5") != refl::u8str::npos);
+
+        auto e = tracked::get_default();
+        defer(e);
+        auto const& ce = e;
+        refl::property_path ratio{tracked::traits_type::get(), "/inner/ratio"};
+        refl::property_path samples{tracked::traits_type::get(), "/samples"};
+        REQUIRE(ratio.find<double>(ce));
+        CHECK(*ratio.find<double>(ce) == 0.25);
+        REQUIRE(samples.find<std::vector<double>>(ce));
+        CHECK(*samples.find<std::vector<double>>(ce) == std::vector({3.5, 4.5}));
+    }
+
+    TEST_CASE("Parallel parsing of object arrays") {
+        auto src = my_markup_type::get_default();
+        for (int i = 0; i < 100; ++i) {
+            auto& elem                 = src.some_obj_arr.emplace_back(my_markup_type::internal_object_type::get_default());
+            elem.single_elem_.ref_path = "/elem/" + std::to_string(i);
+        }
+
+        refl::u8str s;
+        marshal::json_dump{}(src, {s});
+
+        kangsw::thread_pool pool{3};
+        auto dst = my_markup_type::get_default();
+        REQUIRE(marshal::json_parse{}.parallel(pool, 16)(s, dst).has_value() == false);
+        CHECK(dst.some_obj_arr.size() == 101);
+        CHECK(dst.some_obj_arr[100].single_elem_.ref_path == "/elem/99");
+
+        auto sequential = my_markup_type::get_default();
+        REQUIRE(marshal::json_parse{}(s, sequential).has_value() == false);
+        CHECK(refl::equal(sequential, dst));
+
+        // malformed element fails whole parsing, as sequential one does.
+        auto pos = s.rfind(R"("single_elem": null)");
+        REQUIRE(pos != refl::u8str::npos);
+        s.replace(pos, 19, R"("single_elem": [1])");
+        CHECK(marshal::json_parse{}.parallel(pool, 16)(s, dst).has_value());
+        CHECK(marshal::json_parse{}(s, dst).has_value());
+    }
+
+    TEST_CASE("Parallel dump") {
+        auto src = my_markup_type::get_default();
+        for (int i = 0; i < 100; ++i) {
+            src.some_obj_arr.emplace_back(my_markup_type::internal_object_type::get_default());
+            src.some_obj_map["entity" + std::to_string(i)] = my_markup_type::internal_object_type::get_default();
+            src.version_vector.push_back(i);
+        }
+
+        kangsw::thread_pool pool{3};
+        for (int indent : {-1, 0, 2, 4}) {
+            refl::u8str serial, parallel;
+            marshal::json_dump{}(src, {serial, indent});
+            marshal::json_dump{}.parallel(pool, 16)(src, {parallel, indent});
+            CHECK(serial == parallel);
+        }
+    }
+
+    TEST_CASE("Ingest pipeline") {
+        using pipeline = marshal::json_ingest_pipeline;
+
+        refl::u8str ndjson, concatenated;
+        for (int i = 0; i < 50; ++i) {
+            auto o   = parsetest::get_default();
+            o.v1_int = i;
+
+            refl::u8str s;
+            marshal::json_dump{}(o, {s});
+            ndjson.append(s).append(i == 25 ? "\n{broken\n\n" : "\n");
+            concatenated.append(s).append(i == 25 ? " {broken} " : " // comment\n");
+        }
+
+        for (auto framing : {pipeline::framing_type::ndjson, pipeline::framing_type::concatenated}) {
+            auto& stream = framing == pipeline::framing_type::ndjson ? ndjson : concatenated;
+
+            std::vector<int> received;
+            pipeline::options opts;
+            opts.framing        = framing;
+            opts.num_workers    = 3;
+            opts.queue_capacity = 4;
+
+            pipeline ingest{parsetest::traits_type::get(), [&](refl::pooled_object o) {
+                                received.push_back(static_cast<parsetest&>(*o).v1_int);
+                            },
+                            opts};
+
+            // chunks are cut in arbitrary positions.
+            for (size_t pos = 0; pos < stream.size(); pos += 37) { ingest.feed(refl::u8str_view{stream}.substr(pos, 37)); }
+            ingest.finish();
+
+            REQUIRE(received.size() == 50);
+            for (int i = 0; i < 50; ++i) { CHECK(received[i] == i); }
+            CHECK(ingest.num_failed() == 1);
+        }
+
+        // truncated frame must not leave partial input in parser of its slot.
+        {
+            std::vector<int> received;
+            pipeline::options opts;
+            opts.num_workers = opts.queue_capacity = 1;
+
+            pipeline ingest{parsetest::traits_type::get(), [&](refl::pooled_object o) {
+                                received.push_back(static_cast<parsetest&>(*o).v1_int);
+                            },
+                            opts};
+            ingest.feed("{\"v1_int\": 1\n{\"v1_int\": 2}\n{\"v1_int\": 3}\n");
+            ingest.finish();
+
+            CHECK(received == std::vector({2, 3}));
+            CHECK(ingest.num_failed() == 1);
+        }
+
+        // consumer error is reported to feeding thread.
+        pipeline failing{parsetest::traits_type::get(), [](refl::pooled_object) { throw std::runtime_error{"consumer"}; }};
+        CHECK_THROWS_AS((failing.feed(ndjson), failing.finish()), std::runtime_error);
+        CHECK_THROWS_AS(pipeline("no.such.type", [](refl::pooled_object) {}), std::invalid_argument);
+    }
+
+    TEST_CASE("File load and save") {
+        auto src = my_markup_type::get_default();
+        for (int i = 0; i < 100; ++i) {
+            auto& elem                 = src.some_obj_arr.emplace_back(my_markup_type::internal_object_type::get_default());
+            elem.single_elem_.ref_path = "/elem/" + std::to_string(i);
+        }
+
+        refl::u8str expected;
+        marshal::json_dump{}(src, {expected, 2});
+
+        // timestamps lose precision through text, thus compared with parsed one.
+        auto reference = my_markup_type::get_default();
+        REQUIRE(marshal::json_parse{}(expected, reference).has_value() == false);
+
+        auto const path = std::filesystem::temp_directory_path() / "cppmarkup-test-file.json";
+
+        // staging buffer smaller than document makes it written in several chunks.
+        marshal::json_file_options opts;
+        opts.indent       = 2;
+        opts.staging_size = 256;
+        opts.sync         = true;
+        marshal::save_json_file(path, src, opts);
+        CHECK(std::filesystem::file_size(path) == expected.size());
+
+        auto dst = my_markup_type::get_default();
+        REQUIRE(marshal::load_json_file(path, dst).has_value() == false);
+        CHECK(refl::equal(reference, dst));
+
+        std::ifstream file{path, std::ios::binary};
+        auto from_stream = my_markup_type::get_default();
+        REQUIRE(marshal::load_json(file, from_stream, {}, 100).has_value() == false);
+        CHECK(refl::equal(reference, from_stream));
+
+        std::istringstream unseekable{expected};
+        auto from_string = my_markup_type::get_default();
+        REQUIRE(marshal::load_json(unseekable, from_string).has_value() == false);
+        CHECK(refl::equal(reference, from_string));
+
+        auto fp = std::fopen(path.string().c_str(), "rb");
+        REQUIRE(fp != nullptr);
+        auto from_file = my_markup_type::get_default();
+        REQUIRE(marshal::load_json(fp, from_file, {}, 100).has_value() == false);
+        std::fclose(fp);
+        CHECK(refl::equal(reference, from_file));
+
+        // truncated document fails without pointing into released buffer.
+        std::filesystem::resize_file(path, expected.size() / 2);
+        auto failure = marshal::load_json_file(path, dst);
+        REQUIRE(failure.has_value());
+        CHECK(failure->where.empty());
+
+        file.close();
+        std::filesystem::remove(path);
+        CHECK_THROWS_AS(marshal::load_json_file(path, dst), std::system_error);
+        CHECK_THROWS_AS(marshal::save_json_file(path / "no-such-dir" / "x.json", src), std::system_error);
+    }
+
+    CPPMARKUP_OBJECT_TEMPLATE(epochtest) {
+        CPPMARKUP_ELEMENT(plain, refl::timestamp_t{});
+        CPPMARKUP_ELEMENT_F(micro, refl::timestamp_t{}, refl::property_flag::timestamp_epoch_us);
+        CPPMARKUP_ELEMENT_F(readable, refl::timestamp_t{}, refl::property_flag::timestamp_iso8601);
+        CPPMARKUP_ELEMENT(series, std::vector<refl::timestamp_t>(3));
+        CPPMARKUP_ELEMENT(named, (refl::u8str_map<refl::timestamp_t>{{"first", {}}}));
+    };
+
+    CPPMARKUP_OBJECT_TEMPLATE(deferredenc) {
+        CPPMARKUP_TRACK_CHANGES()
+        CPPMARKUP_ELEMENT(stamps, std::vector<refl::timestamp_t>{});
+        CPPMARKUP_ELEMENT(blobs, std::vector<refl::binary_chunk>{});
+    };
+
+    TEST_CASE("Epoch timestamps") {
+        using namespace std::chrono;
+        using encoding = marshal::timestamp_encoding;
+
+        auto const now = refl::timestamp_t::clock::now();
+        auto const ms  = refl::timestamp_t{floor<milliseconds>(now)};
+        auto const us  = refl::timestamp_t{floor<microseconds>(now)};
+
+        epochtest src;
+        src.reset();
+        src.plain = src.readable = ms, src.micro = us;
+        src.series               = {ms, ms - hours{1}, refl::timestamp_t{} - milliseconds{1}};
+        src.named["first"]       = ms;
+
+        auto const count = [](auto d) { return std::to_string(d.count()); };
+
+        refl::u8str epoch;
+        marshal::json_dump{}.timestamps(encoding::epoch_ms)(src, {epoch});
+        MESSAGE(epoch);
+        CHECK(epoch.find(R"("plain": )" + count(floor<milliseconds>(ms.time_since_epoch()))) != epoch.npos);
+        CHECK(epoch.find(R"("micro": )" + count(floor<microseconds>(us.time_since_epoch()))) != epoch.npos);
+        CHECK(epoch.find(R"("readable": ")") != epoch.npos);
+        CHECK(epoch.find("-1]") != epoch.npos);
+
+        epochtest dst;
+        dst.reset();
+        REQUIRE(marshal::json_parse{}.timestamps(encoding::epoch_ms)(epoch, dst).has_value() == false);
+        CHECK(refl::equal(src, dst));
+
+        // property flags apply in default mode as well, and strings are always accepted.
+        refl::u8str iso;
+        marshal::json_dump{}(src, {iso});
+        CHECK(iso.find(R"("plain": ")") != iso.npos);
+        CHECK(iso.find(R"("micro": )" + count(floor<microseconds>(us.time_since_epoch()))) != iso.npos);
+
+        dst.reset();
+        REQUIRE(marshal::json_parse{}(iso, dst).has_value() == false);
+        CHECK(refl::equal(src, dst));
+
+        dst.reset();
+        REQUIRE(marshal::json_parse{}.timestamps(encoding::epoch_ns)(iso, dst).has_value() == false);
+        CHECK(refl::equal(src, dst));
+
+        // numbers are not read as timestamps unless their unit is known.
+        dst.reset();
+        REQUIRE(marshal::json_parse{}(epoch, dst).has_value() == false);
+        CHECK(dst.plain == refl::timestamp_t{});
+        CHECK(dst.micro == us);
+
+        // deferred values are forwarded only if they are dumped in encoding they were parsed in.
+        auto deferred = deferredenc::get_default();
+        REQUIRE(marshal::json_parse{}.defer_nested()(R"({"stamps": ["1970-01-01T00:00:01Z"]})", deferred).has_value() == false);
+        REQUIRE(deferred.state()->any_deferred());
+
+        refl::u8str forwarded, reencoded;
+        marshal::json_dump{}(deferred, {forwarded});
+        CHECK(forwarded.find(R"(["1970-01-01T00:00:01Z"])") != forwarded.npos);
+        marshal::json_dump{}.timestamps(encoding::epoch_ms)(deferred, {reencoded});
+        CHECK(reencoded.find("[1000]") != reencoded.npos);
+    }
+
+    CPPMARKUP_OBJECT_TEMPLATE(bintest) {
+        CPPMARKUP_ELEMENT(plain, refl::binary_chunk{});
+        CPPMARKUP_ELEMENT_F(hexed, refl::binary_chunk{}, refl::property_flag::binary_hex);
+        CPPMARKUP_ELEMENT_F(blob, refl::binary_chunk{}, refl::property_flag::binary_sidecar);
+        CPPMARKUP_ELEMENT(list, std::vector<refl::binary_chunk>{});
+    };
+
+    TEST_CASE("Binary encodings") {
+        using encoding = marshal::binary_encoding;
+
+        auto const bytes = [](std::initializer_list<int> v) {
+            refl::binary_chunk r;
+            for (int b : v) { r.push_back(std::byte(b)); }
+            return r;
+        };
+
+        bintest src;
+        src.reset();
+        src.plain = bytes({1, 2, 3, 4, 5});
+        src.hexed = bytes({0xde, 0xad, 0xbe, 0xef});
+        src.blob.resize(100000);
+        for (size_t i = 0; i < src.blob.size(); ++i) { src.blob[i] = std::byte(i * 31); }
+        src.list = {bytes({9}), {}, bytes({7, 7, 7, 7, 7, 7, 7})};
+
+        // blobs are kept in memory, as if they were streamed next to the document.
+        refl::binary_chunk blobs;
+        auto const writer = [&blobs](void const* data, size_t size) -> uint64_t {
+            auto const offset = blobs.size();
+            blobs.insert(blobs.end(), static_cast<std::byte const*>(data), static_cast<std::byte const*>(data) + size);
+            return offset;
+        };
+        auto const reader = [&blobs](uint64_t offset, size_t size, void* out) {
+            if (offset + size > blobs.size()) { return false; }
+            return memcpy(out, blobs.data() + offset, size), true;
+        };
+
+        for (auto enc : {encoding::base64, encoding::hex, encoding::base85, encoding::sidecar}) {
+            blobs.clear();
+            refl::u8str text;
+            marshal::json_dump{}.binaries(enc).sidecar(writer)(src, {text});
+            CHECK(text.find(R"("hexed": "deadbeef")") != text.npos);
+            CHECK(text.size() < 1000);
+            CHECK(blobs.size() >= src.blob.size());
+
+            bintest dst;
+            dst.reset();
+            REQUIRE(marshal::json_parse{}.binaries(enc).sidecar(reader)(text, dst).has_value() == false);
+            CHECK(refl::equal(src, dst));
+        }
+
+        // blobs out of sidecar are not read.
+        refl::u8str text;
+        blobs.clear();
+        marshal::json_dump{}.sidecar(writer)(src, {text});
+        blobs.resize(blobs.size() / 2);
+        bintest dst;
+        dst.reset();
+        REQUIRE(marshal::json_parse{}.sidecar(reader)(text, dst).has_value() == false);
+        CHECK(dst.blob.empty());
+
+        CHECK_THROWS_AS(marshal::json_dump{}(src, {text}), std::logic_error);
+        CHECK_THROWS_AS(marshal::json_parse{}(text, dst), std::logic_error);
+
+        // sidecar file is written aside of document file.
+        auto const dir = std::filesystem::temp_directory_path();
+        marshal::sidecar_file_writer file_writer{dir / "cppmarkup-test-sidecar.bin"};
+        marshal::save_json_file(dir / "cppmarkup-test-sidecar.json", src, {}, marshal::json_dump{}.sidecar(file_writer));
+        file_writer.close();
+        CHECK(std::filesystem::file_size(dir / "cppmarkup-test-sidecar.bin") == src.blob.size());
+
+        dst.reset();
+        marshal::sidecar_file_reader file_reader{dir / "cppmarkup-test-sidecar.bin"};
+        REQUIRE(marshal::load_json_file(dir / "cppmarkup-test-sidecar.json", dst, marshal::json_parse{}.sidecar(file_reader)).has_value() == false);
+        CHECK(refl::equal(src, dst));
+
+        std::filesystem::remove(dir / "cppmarkup-test-sidecar.json");
+        std::filesystem::remove(dir / "cppmarkup-test-sidecar.bin");
+
+        // deferred binaries are re-encoded in other encodings, and written into sidecar.
+        refl::u8str const deferred_doc = R"({"blobs": [ "AQID" ]})";
+        std::pair<encoding, char const*> const expected[] = {
+          {encoding::base64, R"(["AQID"])"}, {encoding::hex, R"(["010203"])"}, {encoding::sidecar, R"(["0:3"])"}};
+        for (auto [enc, encoded] : expected) {
+            auto deferred = deferredenc::get_default();
+            REQUIRE(marshal::json_parse{}.defer_nested()(deferred_doc, deferred).has_value() == false);
+            REQUIRE(deferred.state()->any_deferred());
+
+            blobs.clear(), text.clear();
+            marshal::json_dump{}.binaries(enc).sidecar(writer)(deferred, {text});
+            CHECK(text.find(encoded) != text.npos);
+            CHECK(blobs.size() == (enc == encoding::sidecar ? 3 : 0));
+        }
+
+        // whitespace of deferred value is not forwarded into minified output.
+        auto deferred = deferredenc::get_default();
+        REQUIRE(marshal::json_parse{}.defer_nested()(deferred_doc, deferred).has_value() == false);
+        text.clear();
+        marshal::json_dump{}(deferred, marshal::minified_output{text});
+        CHECK(text.find(R"("blobs":["AQID"])") != text.npos);
+    }
+
+    TEST_CASE("Print policies") {
+        auto src = my_markup_type::get_default();
+        src.some_obj_arr.resize(3, my_markup_type::internal_object_type::get_default());
+
+        refl::u8str compact, indented;
+        marshal::json_dump{}(src, {compact});
+        marshal::json_dump{}(src, {indented, 2});
+
+        // whitespace outside of strings is what only differs.
+        auto const strip = [](refl::u8str_view s) {
+            refl::u8str r;
+            bool in_string = false;
+            for (size_t i = 0; i < s.size(); ++i) {
+                if (in_string && s[i] == '\\') {
+                    r += s[i++];
+                } else if (s[i] == '"') {
+                    in_string = !in_string;
+                } else if (!in_string && isspace(s[i])) {
+                    continue;
+                }
+                r += s[i];
+            }
+            return r;
+        };
+
+        refl::u8str minified;
+        marshal::json_dump{}(src, marshal::minified_output{minified});
+        CHECK(minified == strip(compact));
+        CHECK(minified.size() < compact.size());
+
+        // pretty layouts have no trailing spaces after separators.
+        refl::u8str pretty, expected = indented;
+        marshal::json_dump{}(src, marshal::pretty_output<2>{pretty});
+        for (size_t pos; (pos = expected.find(", \n")) != expected.npos;) { expected.erase(pos + 1, 1); }
+        CHECK(pretty == expected);
+
+        refl::u8str tabbed;
+        marshal::json_dump{}(src, marshal::tabbed_output{tabbed});
+        CHECK(tabbed.find("\n\t\t\"") != tabbed.npos);
+        CHECK(strip(tabbed) == minified);
+
+        auto reference = my_markup_type::get_default();
+        REQUIRE(marshal::json_parse{}(compact, reference).has_value() == false);
+        for (auto text : {&minified, &pretty, &tabbed}) {
+            auto dst = my_markup_type::get_default();
+            REQUIRE(marshal::json_parse{}(*text, dst).has_value() == false);
+            CHECK(refl::equal(reference, dst));
+        }
+
+        // fragments cached in one layout are never reused by another.
+        auto const dump_reusing = [](auto const& obj, auto o) { return marshal::json_dump{true}(obj, o), o.str(); };
+        refl::u8str buf;
+        CHECK(dump_reusing(src, marshal::minified_output{buf}) == minified);
+        buf.clear();
+        CHECK(dump_reusing(src, marshal::string_output{buf}) == compact);
+        buf.clear();
+        CHECK(dump_reusing(src, marshal::minified_output{buf}) == minified);
+    }
+
+#if !_WIN32
+    TEST_CASE("Non-blocking parse and dump over sockets") {
+        auto src = my_markup_type::get_default();
+        for (int i = 0; i < 2000; ++i) {
+            auto& elem                 = src.some_obj_arr.emplace_back(my_markup_type::internal_object_type::get_default());
+            elem.single_elem_.ref_path = "/elem/" + std::to_string(i);
+        }
+
+        refl::u8str text;
+        marshal::json_dump{}(src, {text});
+        auto reference = my_markup_type::get_default();
+        REQUIRE(marshal::json_parse{}(text, reference).has_value() == false);
+
+        struct connection {
+            int fds[2];
+            my_markup_type dst = my_markup_type::get_default();
+            std::unique_ptr<marshal::json_async_dump> writer;
+            std::unique_ptr<marshal::json_async_parse> reader;
+            bool is_write_closed = false;
+        };
+
+        constexpr int num_connections = 4;
+        std::vector<connection> conns(num_connections);
+        int num_completed = 0, num_suspended = 0;
+
+        for (auto& c : conns) {
+            REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, c.fds) == 0);
+            for (int fd : c.fds) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+            c.writer = std::make_unique<marshal::json_async_dump>(src, [fd = c.fds[0]](refl::u8str_view s) -> size_t {
+                auto n = send(fd, s.data(), s.size(), 0);
+                if (n >= 0) { return n; }
+                if (errno != EAGAIN && errno != EWOULDBLOCK) { throw std::system_error{errno, std::generic_category(), "send"}; }
+                return 0;
+            });
+            c.reader = std::make_unique<marshal::json_async_parse>(c.dst);
+            c.reader->on_complete([&] { ++num_completed; });
+        }
+
+        // single thread multiplexes every connection, as a reactor does.
+        char buf[4096];
+        while (num_completed < num_connections) {
+            std::vector<pollfd> fds;
+            for (auto& c : conns) {
+                if (!c.is_write_closed) { fds.push_back({c.fds[0], POLLOUT}); }
+                if (!c.reader->is_done()) { fds.push_back({c.fds[1], POLLIN}); }
+            }
+            REQUIRE(poll(fds.data(), fds.size(), 5000) > 0);
+
+            for (auto& p : fds) {
+                auto& c = *std::find_if(conns.begin(), conns.end(), [&](auto& c) { return c.fds[0] == p.fd || c.fds[1] == p.fd; });
+                if (p.revents & POLLOUT) {
+                    if (c.writer->pump()) {
+                        shutdown(c.fds[0], SHUT_WR), c.is_write_closed = true;
+                    } else {
+                        ++num_suspended; // socket buffer is full
+                    }
+                } else if (p.revents & (POLLIN | POLLHUP)) {
+                    auto n = recv(p.fd, buf, sizeof buf, 0);
+                    if (n > 0) {
+                        CHECK(c.reader->feed({buf, size_t(n)}) == size_t(n));
+                    } else if (n == 0) {
+                        c.reader->close();
+                    }
+                }
+            }
+        }
+
+        CHECK(num_suspended > 0);
+        for (auto& c : conns) {
+            CHECK(c.reader->result().has_value() == false);
+            CHECK(refl::equal(reference, c.dst));
+            for (int fd : c.fds) { close(fd); }
+        }
+
+        // truncated input fails on close.
+        auto dst = my_markup_type::get_default();
+        marshal::json_async_parse truncated{dst};
+        CHECK(truncated.feed(refl::u8str_view{text}.substr(0, 100)) == 100);
+        CHECK(truncated.is_done() == false);
+        truncated.close();
+        REQUIRE(truncated.result().has_value());
+        CHECK(truncated.result()->code == marshal::json_parse::failure_report::waiting);
+
+#if INTERNAL_CPPMARKUP_HAS_COROUTINE
+        // coroutines are resumed inside feed() and pump(), by the thread which drives them.
+        struct detached {
+            struct promise_type {
+                detached get_return_object() { return {}; }
+                std::suspend_never initial_suspend() { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() {}
+                void unhandled_exception() { std::terminate(); }
+            };
+        };
+
+        bool is_received = false, is_sent = false;
+        auto receive     = [&](marshal::json_async_parse& parse) -> detached {
+            auto result = co_await parse;
+            is_received = !result.has_value();
+        };
+        auto send = [&](marshal::json_async_dump& dump) -> detached {
+            co_await dump;
+            is_sent = true;
+        };
+
+        refl::u8str sent;
+        marshal::json_async_dump out{src, [&](refl::u8str_view s) {
+                                         auto n = std::min<size_t>(s.size(), 4096);
+                                         return sent.append(s.substr(0, n)), n;
+                                     }};
+        marshal::json_async_parse in{dst};
+        send(out), receive(in);
+
+        while (!out.pump()) { CHECK(is_sent == false); }
+        CHECK(is_sent);
+        CHECK(sent == text);
+
+        for (size_t pos = 0; pos < sent.size(); pos += 4096) {
+            CHECK(is_received == false);
+            in.feed(refl::u8str_view{sent}.substr(pos, 4096));
+        }
+        CHECK(is_received);
+        CHECK(refl::equal(reference, dst));
+#endif
+    }
+#endif
+
+    TEST_CASE("Diff and merge patch") {
+        auto const stamp = std::chrono::floor<std::chrono::milliseconds>(refl::timestamp_t::clock::now());
+
+        auto from = my_markup_type::get_default();
+        auto to   = my_markup_type::get_default();
+
+        refl::u8str patch;
+        CHECK(marshal::diff(from, to, {patch}) == false);
+        CHECK(patch == "{}");
+
+        to.rev_minor = 32;
+        to.list_author.emplace_back("\"Quoted\" \\ path");
+        to.some_obj_arr_.encrypt = refl::binary_chunk::from(1, 2, 3);
+        to.some_obj_arr.emplace_back(my_markup_type::internal_object_type::get_default());
+        to.some_obj_map.erase("entity");
+        to.some_obj_map["added"] = my_markup_type::internal_object_type::get_default();
+
+        for (auto& elem : to.some_obj_arr) { elem.single_elem_.creation = stamp; }
+        for (auto& [key, elem] : to.some_obj_map) { elem.single_elem_.creation = stamp; }
+
+        patch.clear();
+        REQUIRE(marshal::diff(from, to, {patch}));
+        MESSAGE(patch);
+        CHECK(patch.find("rev_minor") != patch.npos);
+        CHECK(patch.find("some_dbl") == patch.npos);
+        CHECK(patch.find("\"entity\": null") != patch.npos);
+
+        REQUIRE(marshal::apply_patch(patch, from).has_value() == false);
+        CHECK(from.rev_minor == 32);
+        CHECK(from.list_author == to.list_author);
+        CHECK(from.some_obj_arr.size() == 2);
+        CHECK(from.some_obj_arr_.encrypt == to.some_obj_arr_.encrypt);
+        CHECK(from.some_obj_map.count("entity") == 0);
+        CHECK(from.some_obj_map.count("added") == 1);
+
+        refl::u8str rest;
+        CHECK(marshal::diff(from, to, {rest}) == false);
+        MESSAGE(rest);
     }
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include <cmath>
+#include <utility>
+#include "doctest.h"
+#include "kangsw/markup/reflection/compare.hxx"
+#include "kangsw/markup/reflection/hash.hxx"
+#include "kangsw/markup/reflection/property_path.hxx"
+#include "test_type.hxx"
+
+namespace refl = kangsw::refl;
+
+namespace {
+CPPMARKUP_OBJECT_TEMPLATE(measured) {
+    CPPMARKUP_ELEMENT(scalar, 0.0f);
+    CPPMARKUP_ELEMENT(samples, std::vector<double>(100));
+};
+} // namespace
+
+TEST_SUITE("Reflection.Algorithms") {
+    TEST_CASE("Structural hash") {
+        auto a = my_markup_type::get_default();
+        auto b = my_markup_type::get_default();
+        CHECK(refl::hash(a) == refl::hash(b));
+        CHECK(refl::hash(a, 1) != refl::hash(a, 2));
+
+        b.rev_minor += 1;
+        CHECK(refl::hash(a) != refl::hash(b));
+        b.rev_minor -= 1;
+        CHECK(refl::hash(a) == refl::hash(b));
+
+        // nested object, attribute and container contents are all hashed.
+        b.some_obj_map.begin()->second.single_elem_.ref_path += "/";
+        CHECK(refl::hash(a) != refl::hash(b));
+        b = a;
+
+        b.some_obj_arr_.encrypt.clear();
+        CHECK(refl::hash(a) != refl::hash(b));
+        b = a;
+
+        // moving element between neighboring strings must change hash.
+        a.list_author = {"ab", "c"};
+        b.list_author = {"a", "bc"};
+        CHECK(refl::hash(a) != refl::hash(b));
+    }
+
+    TEST_CASE("Hash agrees with equality") {
+        auto a = measured::get_default(), b = measured::get_default();
+        a.scalar = -0.0f, b.scalar = 0.0f;
+        a.samples[99] = -0.0, b.samples[99] = 0.0;
+        a.samples[0] = std::nan("1"), b.samples[0] = -std::nan("2");
+        REQUIRE(refl::equal(a, b));
+        CHECK(refl::hash(a) == refl::hash(b));
+
+        b.samples[99] = 1e-300;
+        CHECK(refl::hash(a) != refl::hash(b));
+    }
+
+    TEST_CASE("Streaming hasher") {
+        char const text[] = "The quick brown fox jumps over the lazy dog";
+
+        refl::hasher whole, pieces;
+        whole.update(text, sizeof text);
+        for (size_t i = 0; i < sizeof text; i += 3) {
+            pieces.update(text + i, std::min<size_t>(3, sizeof text - i));
+        }
+        CHECK(whole.digest() == pieces.digest());
+
+        refl::hasher shorter;
+        shorter.update(text, sizeof text - 1);
+        CHECK(whole.digest() != shorter.digest());
+    }
+
+    TEST_CASE("Equality and ordering") {
+        auto a = my_markup_type::get_default();
+        auto b = my_markup_type::get_default();
+        CHECK(refl::equal(a, b));
+        CHECK(refl::compare(a, b) == 0);
+
+        // contiguous integer members are compared at once, but ordering follows each member.
+        b.rev_minor2 -= 1, b.rev_minor += 1;
+        CHECK(!refl::equal(a, b));
+        CHECK(refl::compare(a, b) < 0);
+        CHECK(refl::compare(b, a) > 0);
+        CHECK(refl::object_less{}(a, b));
+        b = a;
+
+        a.some_dbl = -0.0, b.some_dbl = 0.0;
+        CHECK(refl::equal(a, b));
+        a.some_dbl = b.some_dbl = std::nan("");
+        CHECK(refl::equal(a, b));
+        b.some_dbl = 1e300;
+        CHECK(refl::compare(a, b) > 0);
+        b = a;
+
+        a.list_author = {"ab", "c"};
+        b.list_author = {"ab", "c", ""};
+        CHECK(refl::compare(a, b) < 0);
+        b.list_author = {"a\xff"};
+        CHECK(refl::compare(a, b) < 0);
+        b = a;
+
+        b.some_obj_map.begin()->second.single_elem_.ref_path += "/";
+        CHECK(!refl::equal(a, b));
+        CHECK(refl::compare(a, b) < 0);
+        b = a;
+
+        b.some_obj_map.emplace("another", b.some_obj_map.begin()->second);
+        CHECK(!refl::equal(a, b));
+        CHECK(refl::compare(a, b) > 0); // "another" < "entity"
+
+        auto const inner = my_markup_type::internal_object_type::get_default();
+        CHECK(!refl::equal(a, inner));
+        CHECK_THROWS_AS(refl::compare(a, inner), std::invalid_argument);
+    }
+
+    TEST_CASE("Compiled property path") {
+        auto& traits = my_markup_type::traits_type::get();
+        auto obj     = my_markup_type::get_default();
+
+        refl::property_path rev{traits, "/rev_minor"};
+        REQUIRE(rev.find<int32_t>(obj) == &obj.rev_minor);
+        *rev.find<int32_t>(obj) = 42;
+        CHECK(obj.rev_minor == 42);
+        CHECK_THROWS_AS(rev.find<double>(obj), refl::property_type_mismatch_exception);
+
+        refl::property_path ref_path{traits, "/some_obj_map/entity/single_elem~0@@ATTR@@/ref_path"};
+        CHECK(ref_path.type() == refl::etype::string);
+        REQUIRE(ref_path.find<refl::u8str>(obj));
+        CHECK(*ref_path.find<refl::u8str>(obj) == "/doc/args");
+
+        refl::property_path stamp{traits, "/some_obj_arr~0@@ATTR@@/stamp"};
+        CHECK(stamp.find<refl::timestamp_t>(obj) == &obj.some_obj_arr_.stamp);
+
+        refl::property_path elem{traits, "/some_obj_arr/0/single_elem"};
+        CHECK(elem.owner(obj) == &obj.some_obj_arr[0]);
+        CHECK(elem.visit(std::as_const(obj), [](auto proxy) { CHECK(proxy.type() == refl::etype::null); }));
+
+        // missing array elements and map entries are resolved as nullptr.
+        obj.some_obj_arr.clear();
+        obj.some_obj_map.clear();
+        CHECK(elem.owner(obj) == nullptr);
+        CHECK(ref_path.find<refl::u8str>(obj) == nullptr);
+        CHECK(!elem.visit(obj, [](auto) {}));
+
+        CHECK_THROWS_AS(refl::property_path(traits, "rev_minor"), refl::invalid_property_path_exception);
+        CHECK_THROWS_AS(refl::property_path(traits, "/nothing"), refl::invalid_property_path_exception);
+        CHECK_THROWS_AS(refl::property_path(traits, "/some_obj_arr/x/single_elem"), refl::invalid_property_path_exception);
+        CHECK_THROWS_AS(refl::property_path(traits, "/some_obj_map/entity"), refl::invalid_property_path_exception);
+        CHECK_THROWS_AS(refl::property_path(traits, "/rev_minor/0"), refl::invalid_property_path_exception);
+    }
+}
@@ -2,6 +2,7 @@
 #include "doctest.h"
 #include "kangsw/markup/reflection/static_object_base.hxx"
 #include "kangsw/markup/macros.hxx"
+#include "kangsw/markup/reflection/type_registry.hxx"
 
 #define default_value "FAS"
 #define elem_name     "hell, wrold!"
@@ -96,27 +97,27 @@ TEST_SUITE("Types.Static Object") {
 
         testobj k;
         static_assert(std::is_same_v<decltype(k.testvarf), double>);
-        static_assert(std::is_same_v<decltype(k.testvari), int64_t>);
+        static_assert(std::is_same_v<decltype(k.testvari), int32_t>);
         static_assert(std::is_same_v<decltype(k.testvars), kangsw::refl::u8str>);
-        static_assert(std::is_same_v<decltype(k.testvaria), std::vector<int64_t>>);
+        static_assert(std::is_same_v<decltype(k.testvaria), std::vector<int32_t>>);
 
         k.reset();
         CHECK(k.testvarf == 15.42);
         CHECK(k.testvari == 154);
         CHECK(k.testvars == "hell, world!");
-        CHECK(k.testvaria == std::vector<int64_t>({1, 2, 3}));
+        CHECK(k.testvaria == std::vector<int32_t>({1, 2, 3}));
 
         k = {};
         CHECK(k.testvarf == 0);
         CHECK(k.testvari == 0);
         CHECK(k.testvars == "");
-        CHECK(k.testvaria == std::vector<int64_t>());
+        CHECK(k.testvaria == std::vector<int32_t>());
 
         k = testobj::get_default();
         CHECK(k.testvarf == 15.42);
         CHECK(k.testvari == 154);
         CHECK(k.testvars == "hell, world!");
-        CHECK(k.testvaria == std::vector<int64_t>({1, 2, 3}));
+        CHECK(k.testvaria == std::vector<int32_t>({1, 2, 3}));
     }
 
     INTERNAL_CPPMARKUP_OBJECT_TEMPLATE(attrtestobj) {
@@ -257,4 +258,91 @@ TEST_SUITE("Types.Static Object") {
         static_assert(std::is_move_assignable_v<newmacrotest>);
         static_assert(std::is_move_constructible_v<newmacrotest>);
     }
-}
\ No newline at end of file
+
+    TEST_CASE("Pooled object factory") {
+        using pool   = kangsw::object_pool<newmacrotest>;
+        auto& traits = newmacrotest::traits_type::get();
+        pool::trim();
+
+        kangsw::refl::object* recycled = nullptr;
+        {
+            auto o = traits.acquire_object();
+            REQUIRE(o);
+            auto& f = static_cast<newmacrotest&>(*o);
+            REQUIRE(f.SomeEmbed2.SomeArr == std::vector({1.4, 1.5, 3.11}));
+
+            f.SomeEmbed2.SomeArr.assign(100, 0.);
+            recycled = o.get();
+        }
+        REQUIRE(pool::num_free() == 1);
+
+        // released instance is reset, then handed out again.
+        auto o = traits.acquire_object();
+        REQUIRE(o.get() == recycled);
+        REQUIRE(pool::num_free() == 0);
+        REQUIRE(static_cast<newmacrotest&>(*o).SomeEmbed2.SomeArr == std::vector({1.4, 1.5, 3.11}));
+
+        // instances beyond capacity are destroyed on release.
+        auto const capacity = pool::capacity();
+        pool::capacity(1);
+        {
+            auto a = traits.acquire_object(), b = traits.acquire_object();
+        }
+        REQUIRE(pool::num_free() == 1);
+        pool::capacity(capacity);
+        pool::trim();
+        REQUIRE(pool::num_free() == 0);
+    }
+
+    CPPMARKUP_NAMED_OBJECT_TEMPLATE(renamed, "tests.renamed") {
+        CPPMARKUP_ELEMENT(SomeInt, 511);
+        CPPMARKUP_ELEMENT(SomeArr, std::vector({1.4, 1.5, 3.11}));
+    };
+
+    TEST_CASE("Type registry") {
+        using kangsw::refl::type_registry;
+        auto& embed_traits = newmacrotest::_SomeEmbed2_VALUE_TYPE::traits_type::get();
+
+        CHECK(newmacrotest::traits_type::get().name() == "newmacrotest");
+        CHECK(embed_traits.name() == "newmacrotest::SomeEmbed2");
+        CHECK(renamed::traits_type::get().name() == "tests.renamed");
+        CHECK(object_type::traits_type::get().name().empty());
+
+        auto& registry = type_registry::global();
+        CHECK(registry.find_traits("newmacrotest") == &newmacrotest::traits_type::get());
+        CHECK(registry.find_traits("newmacrotest::SomeEmbed2") == &embed_traits);
+        CHECK(registry.find_traits("tests.renamed") == &renamed::traits_type::get());
+        CHECK(registry.find_traits("renamed") == nullptr);
+
+        auto obj = registry.find_traits("tests.renamed")->acquire_object();
+        CHECK(static_cast<renamed&>(*obj).SomeInt == 511);
+
+        // fingerprint covers schema only; SomeEmbed2 and renamed share tags and types.
+        CHECK(registry.find("tests.renamed")->fingerprint == kangsw::refl::schema_fingerprint(embed_traits));
+        CHECK(kangsw::refl::schema_fingerprint(embed_traits) != kangsw::refl::schema_fingerprint(newmacrotest::traits_type::get()));
+
+        auto& prop = *newmacrotest::traits_type::get().find_property("SomeEmbed2");
+        CHECK(&prop.get_object_traits() == &embed_traits);
+    }
+
+    namespace first {
+    CPPMARKUP_OBJECT_TEMPLATE(duplicate) { CPPMARKUP_ELEMENT(SomeInt, 1); };
+    } // namespace first
+
+    namespace second {
+    CPPMARKUP_OBJECT_TEMPLATE(duplicate) { CPPMARKUP_ELEMENT(SomeInt, 2); };
+    } // namespace second
+
+    TEST_CASE("Type registry name collision") {
+        using kangsw::refl::type_registry;
+        auto& a = first::duplicate::traits_type::get();
+        auto& b = second::duplicate::traits_type::get();
+        REQUIRE(a.name() == b.name());
+
+        // colliding name is reported only when it is looked up.
+        type_registry registry{{&a, &renamed::traits_type::get(), &b}};
+        CHECK(registry.find_traits("tests.renamed") == &renamed::traits_type::get());
+        CHECK_THROWS_AS(registry.find("duplicate"), kangsw::refl::type_name_collision_exception);
+        CHECK_NOTHROW(type_registry::global());
+    }
+}
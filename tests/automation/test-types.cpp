@@ -1,5 +1,12 @@
 #include "doctest.h"
 #include "kangsw/markup/reflection/property.hxx"
+#include "kangsw/markup/utility/base64.hxx"
+#include "kangsw/markup/utility/base85.hxx"
+#include "kangsw/markup/utility/hex.hxx"
+#include "kangsw/markup/utility/timestamp.hxx"
+#include <ctime>
+#include <optional>
+#include <random>
 
 using namespace kangsw::refl;
 
@@ -12,19 +19,318 @@ static_assert(etype::from_type<std::vector<double>>().leap() == etype::floating_
 static_assert(etype::from_type<std::vector<double>>().is_array());
 static_assert(etype::from_type<u8str_map<double>>().is_map());
 
-static_assert(std::is_same_v<decltype(etype::deduce(324)), int64_t>);
-static_assert(std::is_same_v<decltype(etype::deduce(324.23f)), double>);
+static_assert(std::is_same_v<decltype(etype::deduce(324)), int32_t>);
+static_assert(std::is_same_v<decltype(etype::deduce(324ll)), int64_t>);
+static_assert(std::is_same_v<decltype(etype::deduce(uint8_t{})), uint8_t>);
+static_assert(std::is_same_v<decltype(etype::deduce(short{})), int16_t>);
+static_assert(std::is_same_v<decltype(etype::deduce(324.23f)), float>);
+static_assert(std::is_same_v<decltype(etype::deduce(324.23)), double>);
 static_assert(std::is_same_v<decltype(etype::deduce("hell, world!")), u8str>);
-static_assert(std::is_same_v<decltype(etype::deduce(std::vector<int>{})), std::vector<int64_t>>);
-static_assert(std::is_same_v<decltype(etype::deduce({1, 2, 4})), std::vector<int64_t>>);
+static_assert(std::is_same_v<decltype(etype::deduce(std::vector<int>{})), std::vector<int32_t>>);
+static_assert(std::is_same_v<decltype(etype::deduce({1, 2, 4})), std::vector<int32_t>>);
 static_assert(std::is_same_v<decltype(etype::deduce(nullptr)), nullptr_t>);
 static_assert(std::is_same_v<decltype(etype::deduce(false)), boolean_t>);
 
+static_assert(etype::subtype_from_type<int8_t>() == esubtype::i8);
+static_assert(etype::subtype_from_type<uint32_t>() == esubtype::u32);
+static_assert(etype::subtype_from_type<std::vector<float>>() == esubtype::f32);
+static_assert(etype::subtype_from_type<u8str_map<double>>() == esubtype::f64);
+static_assert(etype::subtype_from_type<boolean_t>() == esubtype::none);
+static_assert(etype::subtype_from_type<u8str>() == esubtype::none);
+static_assert(etype::from_type_exact<uint16_t>() == etype::integer);
+static_assert(etype::from_type_exact<std::vector<float>>() == (etype::array | etype::floating_point));
+static_assert(etype::from_type<bit_vector>() == (etype::array | etype::boolean));
+static_assert(etype::subtype_from_type<bit_vector>() == esubtype::bit);
+static_assert(std::is_same_v<decltype(etype::deduce(bit_vector{})), bit_vector>);
+static_assert(etype::from_type<std::array<float, 3>>() == (etype::array | etype::floating_point));
+static_assert(etype::layout_from_type<std::array<float, 3>>() == elayout::fixed);
+static_assert(etype::layout_from_type<kangsw::small_vector<int, 4>>() == elayout::inlined);
+static_assert(etype::layout_from_type<std::vector<int>>() == elayout::dynamic);
+static_assert(etype::layout_from_type<kangsw::nested_vector<int>>() == elayout::nested);
+static_assert(etype::from_type<kangsw::nested_vector<u8str>>() == (etype::array | etype::string));
+static_assert(std::is_same_v<decltype(etype::deduce(kangsw::nested_vector<long long>{})), kangsw::nested_vector<int64_t>>);
+static_assert(std::is_same_v<decltype(etype::deduce(std::array<int, 2>{})), std::array<int32_t, 2>>);
+static_assert(std::is_same_v<decltype(etype::deduce(kangsw::small_vector<short, 4>{})), kangsw::small_vector<int16_t, 4>>);
+
 namespace tests::types {
 TEST_SUITE("Types") {
     TEST_CASE("Compilation") {
         static_assert(kangsw::templates::is_specialization_of<
                         binary_chunk, std::vector>::value == false);
     }
+
+    TEST_CASE("Bit vector") {
+        bit_vector bits(130, true);
+        CHECK(bits.size() == 130);
+        CHECK(bits.words().size() == 3);
+        CHECK(bits.count() == 130);
+        CHECK(bits.all());
+
+        bits[1] = false, bits[129] = false;
+        CHECK(bits.count() == 128);
+        CHECK(!bits[1]);
+        CHECK(bits[2]);
+
+        bits.flip();
+        CHECK(bits.count() == 2);
+        CHECK(bits.words()[2] == 0b10);
+
+        bit_vector mask(130);
+        mask[129] = true;
+        bits &= mask;
+        CHECK(bits.count() == 1);
+
+        bits.erase(0, 65);
+        CHECK(bits.size() == 65);
+        CHECK(bits[64]);
+        CHECK(bits.count() == 1);
+
+        bit_vector small = {true, false, true, true, false, false, false, false, true};
+        binary_chunk packed;
+        small.pack_into(packed);
+        REQUIRE(packed.size() == 2);
+        CHECK(packed[0] == std::byte{0b1101});
+        CHECK(packed[1] == std::byte{0b1});
+        CHECK(bit_vector::unpack(packed.data(), small.size()) == small);
+    }
+
+    TEST_CASE("Small vector") {
+        kangsw::small_vector<u8str, 2> v = {"a", "b"};
+        CHECK(v.is_inlined());
+
+        v.push_back("c");
+        CHECK(!v.is_inlined());
+        CHECK(v.size() == 3);
+        CHECK(v.back() == "c");
+
+        auto moved = std::move(v);
+        CHECK(moved.size() == 3);
+        CHECK(v.empty());
+        CHECK(v.is_inlined());
+
+        kangsw::small_vector<u8str, 2> copied = {"x"};
+        copied = moved;
+        CHECK(copied == moved);
+
+        copied.erase(copied.begin(), copied.begin() + 2);
+        CHECK(copied.size() == 1);
+        CHECK(copied[0] == "c");
+
+        kangsw::small_vector_base<u8str>& erased = copied;
+        erased.resize(4);
+        CHECK(copied.size() == 4);
+        CHECK(copied[3].empty());
+    }
+
+    TEST_CASE("Nested vector") {
+        kangsw::nested_vector<int> v = {{1, 2}, {}, {3, 4, 5}};
+        CHECK(v.size() == 3);
+        CHECK(v.num_values() == 5);
+        CHECK(v.offsets() == std::vector<size_t>{0, 2, 2, 5});
+        CHECK(v[1].empty());
+        CHECK(v[2][1] == 4);
+
+        v.emplace_back();
+        v.append(6);
+        CHECK(v.back().size() == 1);
+
+        v.erase(0, 2);
+        CHECK(v.size() == 2);
+        CHECK(v.offsets() == std::vector<size_t>{0, 3, 4});
+        CHECK(v[0] == std::vector{3, 4, 5});
+
+        v.clear();
+        CHECK(v.empty());
+        CHECK(v.num_values() == 0);
+    }
+
+    TEST_CASE("Timestamp formatting") {
+        static_assert(kangsw::timestamp::civil_from_days(0).year == 1970);
+        static_assert(kangsw::timestamp::civil_from_days(-1).month == 12);
+        static_assert(kangsw::timestamp::civil_from_days(11016).day == 29); // 2000-02-29
+
+        auto const format = [](timestamp_t t, int digits) {
+            char buf[kangsw::timestamp::max_formatted_size];
+            return std::string(buf, kangsw::timestamp::format(buf, t, digits));
+        };
+
+        using namespace std::chrono;
+        auto const base = timestamp_t{} + seconds{951782399} + nanoseconds{123456789}; // 2000-02-28T23:59:59
+        CHECK(format(base, 0) == "2000-02-28T23:59:59Z");
+        CHECK(format(base, 3) == "2000-02-28T23:59:59.123Z");
+        CHECK(format(base, 6) == "2000-02-28T23:59:59.123456Z");
+        CHECK(format(base, 9) == "2000-02-28T23:59:59.123456789Z");
+        CHECK(format(base + seconds{1}, 3) == "2000-02-29T00:00:00.123Z"); // cached date is refreshed
+        CHECK(format(timestamp_t{} - milliseconds{1}, 3) == "1969-12-31T23:59:59.999Z");
+
+        // agrees with libc over whole range of 64-bit nanoseconds clock.
+        std::mt19937_64 rand{42};
+        std::uniform_int_distribution<int64_t> secs{-9'000'000'000, 9'000'000'000};
+        for (int i = 0; i < 10000; ++i) {
+            time_t const time = secs(rand);
+            tm tm;
+#if _WIN32
+            if (gmtime_s(&tm, &time) != 0) { continue; }
+#else
+            gmtime_r(&time, &tm);
+#endif
+            char expected[32];
+            snprintf(expected, sizeof expected, "%04d-%02d-%02dT%02d:%02d:%02dZ", tm.tm_year + 1900, tm.tm_mon + 1,
+                     tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+            REQUIRE(format(timestamp_t{} + seconds{time}, 0) == expected);
+        }
+    }
+
+    TEST_CASE("Timestamp parsing") {
+        using namespace std::chrono;
+        auto const parse = [](std::string const& s) -> std::optional<timestamp_t> {
+            timestamp_t t;
+            auto end = kangsw::timestamp::parse(s.data(), s.data() + s.size(), t);
+            if (end != s.data() + s.size()) { return {}; }
+            return t;
+        };
+
+        static_assert(kangsw::timestamp::days_from_civil(1970, 1, 1) == 0);
+        static_assert(kangsw::timestamp::days_from_civil(2000, 2, 29) == 11016);
+
+        auto const base = timestamp_t{} + seconds{951782399};
+        CHECK(parse("2000-02-28T23:59:59Z") == base);
+        CHECK(parse("2000-02-28t23:59:59z") == base);
+        CHECK(parse("2000-02-28 23:59:59Z") == base);
+        CHECK(parse("2000-02-28T23:59:59.5Z") == base + milliseconds{500});
+        CHECK(parse("2000-02-28T23:59:59.123456Z") == base + microseconds{123456});
+        CHECK(parse("2000-02-28T23:59:59.1234567891234Z") == base + duration_cast<timestamp_t::duration>(nanoseconds{123456789}));
+        CHECK(parse("2000-02-29T08:59:59+09:00") == base);
+        CHECK(parse("2000-02-28T14:29:59-09:30") == base);
+        CHECK(parse("1969-12-31T23:59:59.999Z") == timestamp_t{} - milliseconds{1});
+        CHECK(parse("2016-12-31T23:59:60Z") == parse("2017-01-01T00:00:00Z"));
+
+        // every truncation of a valid timestamp is rejected without reading past its end.
+        std::string const valid = "2000-02-28T23:59:59.123+09:00";
+        for (size_t n = 0; n < valid.size(); ++n) {
+            std::vector<char> exact(valid.begin(), valid.begin() + n);
+            timestamp_t t;
+            CHECK(kangsw::timestamp::parse(exact.data(), exact.data() + n, t) == nullptr);
+        }
+
+        for (auto bad : {"2000-02-30T00:00:00Z", "1900-02-29T00:00:00Z", "2000-13-01T00:00:00Z", "2000-00-01T00:00:00Z",
+                         "2000-01-01T24:00:00Z", "2000-01-01T00:60:00Z", "2000-01-01T00:00:61Z", "2000-01-01X00:00:00Z",
+                         "2000/01/01T00:00:00Z", "2000-01-01T00:00:00", "2000-01-01T00:00:00.Z", "2000-01-01T00:00:00+9:00",
+                         "2000-01-01T00:00:00+24:00", "20a0-01-01T00:00:00Z", "2000-01-01T00:0:000Z"}) {
+            CHECK_MESSAGE(parse(bad).has_value() == false, bad);
+        }
+
+        // round trip of formatted timestamps.
+        std::mt19937_64 rand{42};
+        std::uniform_int_distribution<int64_t> nanos{-9'000'000'000'000'000'000, 9'000'000'000'000'000'000};
+        for (int i = 0; i < 10000; ++i) {
+            auto const t = timestamp_t{} + duration_cast<timestamp_t::duration>(nanoseconds{nanos(rand)});
+            char buf[kangsw::timestamp::max_formatted_size];
+            auto const s = std::string(buf, kangsw::timestamp::format(buf, t, 9));
+            REQUIRE(parse(s) == t);
+        }
+    }
+
+    TEST_CASE("Base64") {
+        namespace b64 = kangsw::base64;
+        auto const encode = [](std::vector<uint8_t> const& v) {
+            std::string s(b64::encoded_size(v.size()), '\0');
+            REQUIRE(b64::encode_to(v.data(), v.size(), s.data()) == s.data() + s.size());
+            return s;
+        };
+        auto const decode = [](std::string const& s) -> std::optional<std::vector<uint8_t>> {
+            std::vector<uint8_t> v(b64::decoded_size(s.size()));
+            auto const n = b64::decode_to(s.data(), s.size(), v.data());
+            if (n == b64::invalid) { return {}; }
+            return v.resize(n), v;
+        };
+        auto const reference = [](std::vector<uint8_t> const& v) {
+            std::string s;
+            for (size_t i = 0; i < v.size(); i += 3) {
+                uint32_t bits = v[i] << 16;
+                if (i + 1 < v.size()) { bits |= v[i + 1] << 8; }
+                if (i + 2 < v.size()) { bits |= v[i + 2]; }
+                auto const num_chars = std::min<size_t>(v.size() - i, 3) + 1;
+                for (size_t k = 0; k < 4; ++k) { s += k < num_chars ? b64::_table_encode[bits >> (18 - 6 * k) & 0x3f] : '='; }
+            }
+            return s;
+        };
+
+        CHECK(encode({'f', 'o', 'o', 'b', 'a'}) == "Zm9vYmE=");
+        CHECK(decode("Zm9vYg==") == std::vector<uint8_t>{'f', 'o', 'o', 'b'});
+
+        // lengths cover every path of vector kernels and scalar tails.
+        std::mt19937_64 rand{42};
+        for (size_t len : {0, 1, 2, 3, 4, 5, 11, 12, 13, 15, 16, 17, 23, 24, 25, 27, 28, 29, 31, 32, 33, 35, 36, 37,
+                           47, 48, 49, 63, 64, 65, 95, 96, 97, 767, 768, 769, 4099}) {
+            std::vector<uint8_t> data(len);
+            for (auto& b : data) { b = uint8_t(rand()); }
+
+            auto const s = encode(data);
+            REQUIRE(s == reference(data));
+            REQUIRE(decode(s) == data);
+
+            std::vector<uint8_t> legacy;
+            REQUIRE(b64::decode(s.begin(), s.end(), std::back_inserter(legacy)));
+            REQUIRE(legacy == data);
+
+            std::string legacy_str;
+            b64::encode(data.data(), data.size(), std::back_inserter(legacy_str));
+            REQUIRE(legacy_str == s);
+
+            // any invalid character is caught, wherever it is.
+            for (size_t pos = 0; pos < s.size(); pos += 7) {
+                for (char bad : {'\0', '-', '_', '.', ' ', '\n', '=', '\x80', '\xff', '@', '[', '`', '{'}) {
+                    auto broken = s;
+                    if (bad == '=' && pos + 2 >= s.size()) { continue; } // may form valid padding
+                    broken[pos] = bad;
+                    REQUIRE_MESSAGE(decode(broken).has_value() == false, pos);
+                }
+            }
+        }
+
+        for (auto bad : {"Z", "Zm9", "Zm9vY", "Zg=", "Z===", "====", "Zg==Zg==", "Zm=v", "Zh==", "Zm9=", "Zm8v=A==", "Zg== "}) {
+            CHECK_MESSAGE(decode(bad).has_value() == false, bad);
+        }
+
+        std::vector<uint8_t> out;
+        CHECK(b64::decode(std::string_view{"Zg==Zg=="}.begin(), std::string_view{"Zg==Zg=="}.end(), std::back_inserter(out)) == false);
+        CHECK(b64::is_valid_b64_char('+'));
+        CHECK(b64::is_valid_b64_char('=') == false);
+    }
+
+    TEST_CASE("Hex and base85") {
+        std::mt19937_64 rand{42};
+        for (size_t len = 0; len < 40; ++len) {
+            std::vector<uint8_t> data(len), decoded(len);
+            for (auto& b : data) { b = uint8_t(rand()); }
+
+            std::string h(kangsw::hex::encoded_size(len), '\0');
+            kangsw::hex::encode_to(data.data(), len, h.data());
+            REQUIRE(kangsw::hex::decode_to(h.data(), h.size(), decoded.data()) == len);
+            REQUIRE(decoded == data);
+
+            std::string z(kangsw::base85::encoded_size(len), '\0');
+            REQUIRE(kangsw::base85::encode_to(data.data(), len, z.data()) == z.data() + z.size());
+            REQUIRE(kangsw::base85::decoded_size(z.size()) == len);
+            REQUIRE(kangsw::base85::decode_to(z.data(), z.size(), decoded.data()) == len);
+            REQUIRE(decoded == data);
+            REQUIRE(z.find_first_of("\"\\") == z.npos);
+        }
+
+        uint8_t const hello[] = {0x86, 0x4f, 0xd2, 0x6f, 0xb5, 0x59, 0xf7, 0x5b};
+        char z85[10];
+        kangsw::base85::encode_to(hello, sizeof hello, z85);
+        CHECK(std::string(z85, 10) == "HelloWorld");
+
+        uint8_t out[8];
+        CHECK(kangsw::hex::decode_to("DEADbeef", 8, out) == 4);
+        CHECK(out[0] == 0xde);
+        CHECK(kangsw::hex::decode_to("abc", 3, out) == kangsw::hex::invalid);
+        CHECK(kangsw::hex::decode_to("0g", 2, out) == kangsw::hex::invalid);
+        CHECK(kangsw::base85::decode_to("Hello\"", 6, out) == kangsw::base85::invalid);
+        CHECK(kangsw::base85::decode_to("Hello0", 6, out) == kangsw::base85::invalid);
+        CHECK(kangsw::base85::decode_to("#####", 5, out) == kangsw::base85::invalid); // exceeds 32 bits
+    }
 }
 } // namespace tests::types
\ No newline at end of file
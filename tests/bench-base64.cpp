@@ -0,0 +1,85 @@
+// Measures base64 throughput of binary chunks, against previous per-character implementation.
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench_common.hxx"
+#include "kangsw/markup/utility/base64.hxx"
+
+namespace b64 = kangsw::base64;
+
+static void encode_legacy(uint8_t const* data, size_t len, std::string& o) {
+    for (; len >= 3; len -= 3, data += 3) {
+        char blk[4];
+        b64::_encode_blk(blk, data);
+        for (char ch : blk) { o.push_back(ch); }
+    }
+    if (len) {
+        uint8_t in[3] = {};
+        char blk[4];
+        for (size_t i = 0; i < len; ++i) { in[i] = data[i]; }
+        b64::_encode_blk(blk, in);
+        for (size_t i = 0; i < 4; ++i) { o.push_back(i <= len ? blk[i] : '='); }
+    }
+}
+
+static bool decode_legacy(std::string const& s, std::vector<uint8_t>& o) {
+    for (size_t i = 0; i < s.size(); i += 4) {
+        int64_t bits = 0;
+        int num_chars = 0;
+        for (; num_chars < 4 && s[i + num_chars] != '='; ++num_chars) {
+            auto v = b64::_table_decode[uint8_t(s[i + num_chars])];
+            if (v == 0xff) { return false; }
+            bits |= int64_t(v) << (3 - num_chars) * 6;
+        }
+        for (int k = 0; k < num_chars - 1; ++k) { o.push_back(uint8_t(bits >> (16 - k * 8))); }
+    }
+    return true;
+}
+
+int main() {
+#if INTERNAL_KANGSW_BASE64_AVX2
+    printf("kernel: AVX2\n");
+#elif INTERNAL_KANGSW_BASE64_SSSE3
+    printf("kernel: SSSE3\n");
+#else
+    printf("kernel: scalar\n");
+#endif
+
+    std::mt19937_64 rand{42};
+    size_t checksum = 0;
+
+    printf("%-10s %-10s %10s %10s\n", "size", "method", "ms", "GB/s");
+    for (size_t size : {size_t(64), size_t(4) << 10, size_t(1) << 20, size_t(64) << 20}) {
+        int const num_iterations = int(std::max<size_t>(1, (size_t(256) << 20) / size));
+
+        std::vector<uint8_t> data(size);
+        for (auto& b : data) { b = uint8_t(rand()); }
+
+        std::string text(b64::encoded_size(size), '\0');
+        std::vector<uint8_t> decoded(b64::decoded_size(text.size()));
+
+        auto const report = [&](char const* method, double ms) {
+            char label[24];
+            snprintf(label, sizeof label, "%zuB", size);
+            printf("%-10s %-10s %10.4f %10.2f\n", label, method, ms, size / ms / 1e6);
+        };
+
+        report("enc-old", measure(num_iterations, [&] {
+                   std::string o;
+                   encode_legacy(data.data(), size, o);
+                   checksum += o.size();
+               }));
+        report("enc", measure(num_iterations, [&] {
+                   checksum += b64::encode_to(data.data(), size, text.data()) - text.data();
+               }));
+        report("dec-old", measure(num_iterations, [&] {
+                   std::vector<uint8_t> o;
+                   checksum += decode_legacy(text, o) + o.size();
+               }));
+        report("dec", measure(num_iterations, [&] {
+                   checksum += b64::decode_to(text.data(), text.size(), decoded.data());
+               }));
+    }
+    printf("(checksum %zu)\n", checksum);
+}
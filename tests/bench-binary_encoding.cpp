@@ -0,0 +1,58 @@
+// Compares document size and round trip time of binary encodings, for a document carrying a few
+// large blobs; i.e. images or model weights.
+#include <cstdio>
+#include <random>
+#include "bench_common.hxx"
+#include "kangsw/markup.hxx"
+#include "kangsw/markup/marshal/json.hxx"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+CPPMARKUP_OBJECT_TEMPLATE(model) {
+    CPPMARKUP_ELEMENT(name, "resnet");
+    CPPMARKUP_ELEMENT(layers, std::vector<refl::binary_chunk>{});
+};
+
+int main() {
+    constexpr int num_layers     = 8;
+    constexpr size_t layer_size  = 4 << 20;
+    constexpr int num_iterations = 5;
+
+    model src;
+    src.reset();
+    std::mt19937_64 rand{42};
+    for (int i = 0; i < num_layers; ++i) {
+        auto& layer = src.layers.emplace_back(layer_size);
+        for (auto& b : layer) { b = std::byte(rand()); }
+    }
+
+    refl::binary_chunk blobs;
+    auto const writer = [&blobs](void const* data, size_t size) -> uint64_t {
+        auto const offset = blobs.size();
+        blobs.insert(blobs.end(), static_cast<std::byte const*>(data), static_cast<std::byte const*>(data) + size);
+        return offset;
+    };
+    auto const reader = [&blobs](uint64_t offset, size_t size, void* out) {
+        return memcpy(out, blobs.data() + offset, size), offset + size <= blobs.size();
+    };
+
+    printf("%-10s %14s %12s %12s\n", "encoding", "json bytes", "dump ms", "parse ms");
+    for (auto [name, enc] : {std::pair{"base64", marshal::binary_encoding::base64}, std::pair{"hex", marshal::binary_encoding::hex},
+                             std::pair{"base85", marshal::binary_encoding::base85}, std::pair{"sidecar", marshal::binary_encoding::sidecar}}) {
+        refl::u8str text;
+        auto const dump = measure(num_iterations, [&] {
+            text.clear(), blobs.clear();
+            marshal::json_dump{}.binaries(enc).sidecar(writer)(src, {text});
+        });
+
+        model dst;
+        dst.reset();
+        auto const parse = measure(num_iterations, [&] {
+            if (marshal::json_parse{}.binaries(enc).sidecar(reader)(text, dst)) { printf("parse failed\n"); }
+        });
+        if (!refl::equal(src, dst)) { printf("round trip mismatch\n"); }
+
+        printf("%-10s %14zu %12.2f %12.2f\n", name, text.size(), dump, parse);
+    }
+}
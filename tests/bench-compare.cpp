@@ -0,0 +1,45 @@
+// Compares refl::equal against comparing serialized JSON, on objects which differ only at the end.
+#include <cstdio>
+#include "bench_common.hxx"
+#include "kangsw/markup.hxx"
+#include "kangsw/markup/marshal/json.hxx"
+#include "kangsw/markup/reflection/compare.hxx"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+CPPMARKUP_OBJECT_TEMPLATE(sample) {
+    CPPMARKUP_ELEMENT(id, 0);
+    CPPMARKUP_ELEMENT(seq, 0);
+    CPPMARKUP_ELEMENT(flags, 0);
+    CPPMARKUP_ELEMENT(count, 0);
+    CPPMARKUP_ELEMENT(values, std::vector({1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}));
+    CPPMARKUP_ELEMENT(label, "sample label");
+    CPPMARKUP_ELEMENT(weight, 0.5);
+};
+
+CPPMARKUP_OBJECT_TEMPLATE(frame) {
+    CPPMARKUP_ELEMENT(revision, 0);
+    CPPMARKUP_ELEMENT(samples, std::vector(64, sample::get_default()));
+};
+
+int main() {
+    constexpr int num_iterations = 2000;
+
+    auto a = frame::get_default(), b = a;
+    b.samples.back().weight = 1.5;
+
+    int num_equal = 0;
+
+    auto dump_us = measure<std::micro>(num_iterations, [&] {
+        refl::u8str x, y;
+        marshal::json_dump{}(a, {x}), marshal::json_dump{}(b, {y});
+        num_equal += x == y;
+    });
+
+    auto equal_us = measure<std::micro>(num_iterations, [&] { num_equal += refl::equal(a, b); });
+
+    printf("json_dump + compare: %8.3f us/iter\n", dump_us);
+    printf("refl::equal:         %8.3f us/iter\n", equal_us);
+    printf("(%d)\n", num_equal);
+}
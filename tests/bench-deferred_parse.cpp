@@ -0,0 +1,47 @@
+// Compares store-and-forward of envelopes, of which payload is never inspected, with and
+//without deferred parsing of nested values.
+#include <cstdio>
+#include "automation/test_type.hxx"
+#include "bench_common.hxx"
+#include "kangsw/markup/marshal/json.hxx"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+CPPMARKUP_OBJECT_TEMPLATE(envelope) {
+    CPPMARKUP_TRACK_CHANGES()
+
+    CPPMARKUP_ELEMENT(id, 0);
+    CPPMARKUP_ELEMENT(route, "none");
+    CPPMARKUP_ELEMENT(payload, std::vector({my_markup_type::internal_object_type::get_default()}));
+};
+
+int main() {
+    printf("%8s %10s %14s %14s\n", "elems", "bytes", "eager(us)", "deferred(us)");
+    for (int num_elems : {1, 10, 100, 1000}) {
+        auto src = envelope::get_default();
+        src.payload.resize(num_elems, my_markup_type::internal_object_type::get_default());
+
+        refl::u8str doc;
+        marshal::json_dump{}(src, {doc});
+
+        int const num_iterations = std::max(10, 20000 / num_elems);
+        auto dst                 = envelope::get_default();
+        refl::u8str out;
+
+        // read routing header, then forward whole envelope.
+        marshal::json_parse eager;
+        auto eager_us = measure<std::micro>(num_iterations, [&] {
+            eager(doc, dst);
+            out.clear(), marshal::json_dump{}(dst, {out});
+        });
+
+        marshal::json_parse deferred;
+        deferred.defer_nested();
+        auto deferred_us = measure<std::micro>(num_iterations, [&] {
+            deferred(doc, dst);
+            out.clear(), marshal::json_dump{}(dst, {out});
+        });
+        printf("%8d %10zu %14.2f %14.2f\n", num_elems, doc.size(), eager_us, deferred_us);
+    }
+}
@@ -0,0 +1,69 @@
+// Measures json_dump with and without fragment reuse, where 1% of properties change per iteration.
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include "kangsw/markup.hxx"
+#include "kangsw/markup/marshal/json.hxx"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+CPPMARKUP_OBJECT_TEMPLATE(record) {
+    CPPMARKUP_TRACK_CHANGES()
+
+    CPPMARKUP_ELEMENT(f00, 0);
+    CPPMARKUP_ELEMENT(f01, 1.5);
+    CPPMARKUP_ELEMENT(f02, "lorem ipsum dolor sit amet");
+    CPPMARKUP_ELEMENT(f03, std::vector({1, 2, 3, 4, 5, 6, 7, 8}));
+    CPPMARKUP_ELEMENT(f04, 4);
+    CPPMARKUP_ELEMENT(f05, 5.5);
+    CPPMARKUP_ELEMENT(f06, "consectetur adipiscing elit");
+    CPPMARKUP_ELEMENT(f07, std::vector({0.5, 1.5, 2.5, 3.5}));
+    CPPMARKUP_ELEMENT(f08, 8);
+    CPPMARKUP_ELEMENT(f09, 9.5);
+};
+
+CPPMARKUP_OBJECT_TEMPLATE(document) {
+    CPPMARKUP_TRACK_CHANGES()
+
+    CPPMARKUP_ELEMENT(revision, 0);
+    CPPMARKUP_ELEMENT(records, std::vector(100, record::get_default()));
+};
+
+int main() {
+    constexpr int num_iterations = 200;
+
+    auto doc                = document::get_default();
+    auto& props             = record::traits_type::get().props();
+    size_t const num_props  = doc.records.size() * props.size();
+    size_t const num_change = num_props / 100;
+
+    std::mt19937 rand{42};
+    std::uniform_int_distribution<size_t> pick{0, num_props - 1};
+
+    for (bool reuse : {false, true}) {
+        refl::u8str out;
+        auto total = std::chrono::steady_clock::duration{};
+
+        for (int iter = 0; iter < num_iterations; ++iter) {
+            for (size_t i = 0; i < num_change; ++i) {
+                auto index = pick(rand);
+                auto& rec  = doc.records[index / props.size()];
+                auto& prop = props[index % props.size()];
+
+                refl::visit_property(rec.base(), prop, [iter](auto proxy) {
+                    if constexpr (proxy.type() == refl::etype::integer) { *proxy = iter; }
+                });
+            }
+
+            auto begin = std::chrono::steady_clock::now();
+            out.clear();
+            marshal::json_dump{reuse}(doc, {out, 2});
+            total += std::chrono::steady_clock::now() - begin;
+        }
+
+        using namespace std::chrono;
+        printf("reuse_fragments=%d: %8.2f us/iter, %zu bytes\n", reuse,
+               duration_cast<nanoseconds>(total).count() / 1e3 / num_iterations, out.size());
+    }
+}
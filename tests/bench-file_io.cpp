@@ -0,0 +1,51 @@
+// Compares loading and saving json file through memory mapping and bounded staging buffer, against
+// reading whole file into string and dumping whole document before writing.
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "automation/test_type.hxx"
+#include "bench_common.hxx"
+#include "kangsw/markup/marshal/json.hxx"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+int main() {
+    constexpr int num_elems      = 100000;
+    constexpr int num_iterations = 5;
+
+    auto src = my_markup_type::get_default();
+    src.some_obj_arr.resize(num_elems, my_markup_type::internal_object_type::get_default());
+
+    auto const path = std::filesystem::temp_directory_path() / "cppmarkup-bench-file_io.json";
+
+    auto const naive_save = measure(num_iterations, [&] {
+        refl::u8str s;
+        marshal::json_dump{}(src, {s, 2});
+        std::ofstream{path, std::ios::binary}.write(s.data(), s.size());
+    });
+    auto const staged_save = measure(num_iterations, [&] { marshal::save_json_file(path, src, {2}); });
+
+    auto dst              = my_markup_type::get_default();
+    auto const naive_load = measure(num_iterations, [&] {
+        std::ostringstream ss;
+        ss << std::ifstream{path, std::ios::binary}.rdbuf();
+        marshal::json_parse{}(ss.str(), dst);
+    });
+    auto const mapped_load = measure(num_iterations, [&] { marshal::load_json_file(path, dst); });
+    auto const stream_load = measure(num_iterations, [&] {
+        std::ifstream file{path, std::ios::binary};
+        marshal::load_json(file, dst);
+    });
+
+    auto const size = std::filesystem::file_size(path);
+    std::filesystem::remove(path);
+
+    printf("%ju bytes\n", uintmax_t(size));
+    printf("%-24s %10s %10s\n", "", "ms", "MB/s");
+    printf("%-24s %10.2f %10.1f\n", "save: dump then write", naive_save, size / naive_save / 1e3);
+    printf("%-24s %10.2f %10.1f\n", "save: staged", staged_save, size / staged_save / 1e3);
+    printf("%-24s %10.2f %10.1f\n", "load: stringstream", naive_load, size / naive_load / 1e3);
+    printf("%-24s %10.2f %10.1f\n", "load: mapped", mapped_load, size / mapped_load / 1e3);
+    printf("%-24s %10.2f %10.1f\n", "load: chunked stream", stream_load, size / stream_load / 1e3);
+}
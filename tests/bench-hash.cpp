@@ -0,0 +1,33 @@
+// Compares structural hash against hashing serialized JSON of same object.
+#include <cstdio>
+#include <functional>
+#include "automation/test_type.hxx"
+#include "bench_common.hxx"
+#include "kangsw/markup/marshal/json.hxx"
+#include "kangsw/markup/reflection/hash.hxx"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+int main() {
+    constexpr int num_iterations = 20000;
+
+    auto obj      = my_markup_type::get_default();
+    size_t unused = 0;
+
+    auto dump_us = measure<std::micro>(num_iterations, [&](int iter) {
+        refl::u8str out;
+        obj.rev_major = iter;
+        marshal::json_dump{}(obj, {out, -1});
+        unused ^= std::hash<std::string_view>{}({(char const*)out.data(), out.size()});
+    });
+
+    auto hash_us = measure<std::micro>(num_iterations, [&](int iter) {
+        obj.rev_major = iter;
+        unused ^= refl::hash(obj);
+    });
+
+    printf("json_dump + std::hash: %8.3f us/iter\n", dump_us);
+    printf("refl::hash:            %8.3f us/iter\n", hash_us);
+    printf("(%zx)\n", unused);
+}
@@ -0,0 +1,66 @@
+// Measures end-to-end throughput of framed stream ingest over growing number of parse workers.
+#include <cstdio>
+#include "automation/test_type.hxx"
+#include "bench_common.hxx"
+#include "kangsw/markup/marshal/json.hxx"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+int main() {
+    constexpr int num_objects  = 20000;
+    constexpr size_t chunk_len = 64 << 10;
+
+    refl::u8str ndjson, concatenated;
+    for (int i = 0; i < num_objects; ++i) {
+        auto o      = my_markup_type::get_default();
+        o.rev_minor = i;
+
+        refl::u8str s;
+        marshal::json_dump{}(o, {s});
+        ndjson.append(s).append("\n");
+        concatenated.append(s);
+    }
+
+    int64_t sum         = 0;
+    auto const consumer = [&sum](refl::pooled_object o) { sum += static_cast<my_markup_type&>(*o).rev_minor; };
+    auto const feed     = [](marshal::json_ingest_pipeline& p, refl::u8str_view stream) {
+        for (size_t pos = 0; pos < stream.size(); pos += chunk_len) { p.feed(stream.substr(pos, chunk_len)); }
+        p.finish();
+    };
+
+    // framing and parsing on single thread, as a baseline.
+    auto const serial = measure([&] {
+        marshal::json_parse parse;
+        auto o = my_markup_type::get_default();
+        for (size_t pos = 0, end; pos < ndjson.size(); pos = end + 1) {
+            end = ndjson.find('\n', pos);
+            parse(refl::u8str_view{ndjson}.substr(pos, end - pos), o);
+            sum += o.rev_minor;
+        }
+    });
+
+    printf("%d objects, %zu bytes, %u hardware threads\n", num_objects, ndjson.size(), std::thread::hardware_concurrency());
+    printf("%8s %14s %14s %16s\n", "workers", "ndjson(MB/s)", "concat(MB/s)", "ndjson(obj/s)");
+    printf("%8s %14.1f %14s %16.0f\n", "serial", ndjson.size() / serial / 1e3, "-", num_objects / serial * 1e3);
+
+    for (size_t num_workers : {1, 2, 4, 8, 16}) {
+        marshal::json_ingest_pipeline::options opts;
+        opts.num_workers = num_workers;
+
+        double ndjson_ms, concat_ms;
+        {
+            marshal::json_ingest_pipeline p{my_markup_type::traits_type::get(), consumer, opts};
+            ndjson_ms = measure([&] { feed(p, ndjson); });
+        }
+        {
+            opts.framing = marshal::json_framing::concatenated;
+            marshal::json_ingest_pipeline p{my_markup_type::traits_type::get(), consumer, opts};
+            concat_ms = measure([&] { feed(p, concatenated); });
+        }
+
+        printf("%8zu %14.1f %14.1f %16.0f\n", num_workers, ndjson.size() / ndjson_ms / 1e3,
+               concatenated.size() / concat_ms / 1e3, num_objects / ndjson_ms * 1e3);
+    }
+    printf("(%lld)\n", (long long)sum);
+}
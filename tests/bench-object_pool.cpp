@@ -0,0 +1,36 @@
+// Compares create_empty_object() against pooled acquire_object(), as a message handler would use them.
+#include <cstdio>
+#include "bench_common.hxx"
+#include "kangsw/markup.hxx"
+
+namespace refl = kangsw::refl;
+
+CPPMARKUP_OBJECT_TEMPLATE(message) {
+    CPPMARKUP_ELEMENT(id, 0);
+    CPPMARKUP_ELEMENT(topic, "sensor/frame");
+    CPPMARKUP_ELEMENT(payload, std::vector({0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0}));
+    CPPMARKUP_ELEMENT(tags, std::vector({"a", "b", "c"}));
+};
+
+int main() {
+    constexpr int num_iterations = 200000;
+    auto& traits = message::traits_type::get();
+    int64_t sum  = 0;
+
+    auto create_us = measure<std::micro>(num_iterations, [&](int iter) {
+        auto o = traits.create_empty_object();
+        o->reset();
+        auto& m = static_cast<message&>(*o);
+        m.id = iter, sum += m.id + m.payload.size();
+    });
+
+    auto pooled_us = measure<std::micro>(num_iterations, [&](int iter) {
+        auto o  = traits.acquire_object();
+        auto& m = static_cast<message&>(*o);
+        m.id = iter, sum += m.id + m.payload.size();
+    });
+
+    printf("create_empty_object: %8.3f us/object\n", create_us);
+    printf("acquire_object:      %8.3f us/object\n", pooled_us);
+    printf("(%lld)\n", (long long)sum);
+}
@@ -0,0 +1,33 @@
+// Measures dump throughput of document with huge object array and map over growing number of threads.
+#include <cstdio>
+#include "automation/test_type.hxx"
+#include "bench_common.hxx"
+#include "kangsw/markup/marshal/json.hxx"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+int main() {
+    constexpr int num_elems      = 200000;
+    constexpr int num_iterations = 5;
+
+    auto src = my_markup_type::get_default();
+    src.some_obj_arr.resize(num_elems, my_markup_type::internal_object_type::get_default());
+    for (int i = 0; i < num_elems / 4; ++i) {
+        src.some_obj_map["entity" + std::to_string(i)] = my_markup_type::internal_object_type::get_default();
+    }
+
+    refl::u8str out;
+    auto const serial = measure(num_iterations, [&] { out.clear(), marshal::json_dump{}(src, {out, 2}); });
+    auto const size   = out.size();
+
+    printf("%zu bytes, %u hardware threads\n", size, std::thread::hardware_concurrency());
+    printf("%8s %10s %10s %10s\n", "threads", "dump(ms)", "MB/s", "speedup");
+    printf("%8s %10.2f %10.1f %10.2f\n", "serial", serial, size / serial / 1e3, 1.0);
+
+    for (size_t num_threads : {1, 2, 4, 8, 16}) {
+        kangsw::thread_pool pool{num_threads - 1}; // calling thread takes part
+        auto ms = measure(num_iterations, [&] { out.clear(), marshal::json_dump{}.parallel(pool)(src, {out, 2}); });
+        printf("%8zu %10.2f %10.1f %10.2f\n", num_threads, ms, size / ms / 1e3, serial / ms);
+    }
+}
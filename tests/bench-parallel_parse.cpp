@@ -0,0 +1,31 @@
+// Measures parsing of document with a huge object array over growing number of threads.
+#include <cstdio>
+#include "automation/test_type.hxx"
+#include "bench_common.hxx"
+#include "kangsw/markup/marshal/json.hxx"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+int main() {
+    constexpr int num_elems      = 200000;
+    constexpr int num_iterations = 5;
+
+    auto src = my_markup_type::get_default();
+    src.some_obj_arr.resize(num_elems, my_markup_type::internal_object_type::get_default());
+
+    refl::u8str doc;
+    marshal::json_dump{}(src, {doc});
+    printf("%d elements, %zu bytes, %u hardware threads\n", num_elems, doc.size(), std::thread::hardware_concurrency());
+
+    auto dst        = my_markup_type::get_default();
+    auto const base = measure(num_iterations, [&] { marshal::json_parse{}(doc, dst); });
+    printf("%8s %12s %10s\n", "threads", "parse(ms)", "speedup");
+    printf("%8s %12.2f %10.2f\n", "seq", base, 1.0);
+
+    for (size_t num_threads : {1, 2, 4, 8, 16}) {
+        kangsw::thread_pool pool{num_threads - 1}; // calling thread takes part
+        auto ms = measure(num_iterations, [&] { marshal::json_parse{}.parallel(pool)(doc, dst); });
+        printf("%8zu %12.2f %10.2f\n", num_threads, ms, base / ms);
+    }
+}
@@ -0,0 +1,32 @@
+// Compares output size and dump speed of print policies, against runtime indentation.
+#include <cstdio>
+#include "automation/test_type.hxx"
+#include "bench_common.hxx"
+#include "kangsw/markup/marshal/json.hxx"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+int main() {
+    constexpr int num_elems      = 100000;
+    constexpr int num_iterations = 5;
+
+    auto src = my_markup_type::get_default();
+    src.some_obj_arr.resize(num_elems, my_markup_type::internal_object_type::get_default());
+
+    refl::u8str buf;
+    auto const run = [&](char const* name, auto make_output) {
+        auto const ms = measure(num_iterations, [&] {
+            buf.clear();
+            marshal::json_dump{}(src, make_output(buf));
+        });
+        printf("%-16s %12zu %10.2f\n", name, buf.size(), ms);
+    };
+
+    printf("%-16s %12s %10s\n", "layout", "bytes", "ms");
+    run("runtime(-1)", [](refl::u8str& s) { return marshal::string_output{s}; });
+    run("minified", [](refl::u8str& s) { return marshal::minified_output{s}; });
+    run("runtime(2)", [](refl::u8str& s) { return marshal::string_output{s, 2}; });
+    run("pretty<2>", [](refl::u8str& s) { return marshal::pretty_output<2>{s}; });
+    run("tabs", [](refl::u8str& s) { return marshal::tabbed_output{s}; });
+}
@@ -0,0 +1,36 @@
+// Compares full parse against projection parse, which materializes only a few properties,
+//over documents of growing size.
+#include <cstdio>
+#include "automation/test_type.hxx"
+#include "bench_common.hxx"
+#include "kangsw/markup/marshal/json.hxx"
+
+namespace refl    = kangsw::refl;
+namespace marshal = refl::marshal;
+
+int main() {
+    marshal::json_projection projection{
+      my_markup_type::traits_type::get(), {"/rev_major", "/rev_minor", "/some_dbl"}};
+
+    printf("%8s %10s %14s %14s\n", "scale", "bytes", "full(us)", "projected(us)");
+    for (int scale : {1, 10, 100, 1000}) {
+        auto src = my_markup_type::get_default();
+        for (int i = 0; i < scale; ++i) {
+            src.some_obj_arr.emplace_back(my_markup_type::internal_object_type::get_default());
+            src.some_obj_map["entity" + std::to_string(i)] = my_markup_type::internal_object_type::get_default();
+            src.list_author.emplace_back("author " + std::to_string(i));
+            src.version_vector.push_back(i);
+        }
+
+        refl::u8str doc;
+        marshal::json_dump{}(src, {doc});
+
+        int const num_iterations = std::max(10, 20000 / scale);
+        marshal::json_parse parse;
+        auto dst = my_markup_type::get_default();
+
+        auto full_us      = measure<std::micro>(num_iterations, [&] { parse(doc, dst); });
+        auto projected_us = measure<std::micro>(num_iterations, [&] { parse(doc, dst, projection); });
+        printf("%8d %10zu %14.2f %14.2f\n", scale, doc.size(), full_us, projected_us);
+    }
+}
@@ -0,0 +1,36 @@
+// Compares compiled property path against resolving same path by tags on every access.
+#include <cstdio>
+#include <utility>
+#include "automation/test_type.hxx"
+#include "bench_common.hxx"
+#include "kangsw/markup/reflection/property_path.hxx"
+
+namespace refl = kangsw::refl;
+
+int main() {
+    constexpr int num_iterations = 1000000;
+
+    auto obj     = my_markup_type::get_default();
+    auto& traits = my_markup_type::traits_type::get();
+    size_t sum   = 0;
+
+    auto lookup_ns = measure<std::nano>(num_iterations, [&] {
+        auto& map_prop = *traits.find_property("some_obj_map");
+        auto entry     = map_prop.omi()->find(map_prop.memory()(obj.base()), "entity");
+        auto& elem     = *entry->traits().find_property("single_elem");
+        auto& attrs    = elem.attributes();
+        auto attr      = std::find_if(attrs.begin(), attrs.end(), [](auto& a) { return a.name == "ref_path"; });
+        refl::visit_property(std::as_const(*entry).base(), *attr, [&](auto proxy) {
+            if constexpr (proxy.type() == refl::etype::string) { sum += proxy->size(); }
+        });
+    });
+
+    refl::property_path path{traits, "/some_obj_map/entity/single_elem~0@@ATTR@@/ref_path"};
+    auto path_ns = measure<std::nano>(num_iterations, [&] {
+        sum += path.find<refl::u8str>(std::as_const(obj))->size();
+    });
+
+    printf("lookup by tags:  %8.2f ns/access\n", lookup_ns);
+    printf("compiled path:   %8.2f ns/access\n", path_ns);
+    printf("(%zu)\n", sum);
+}
@@ -0,0 +1,93 @@
+// Measures timestamps formatted and parsed per second, against previous libc based implementations.
+#include <chrono>
+#include <cstdio>
+#include <charconv>
+#include <ctime>
+#include <string>
+#include <vector>
+#include "bench_common.hxx"
+#include "kangsw/markup/types.hxx"
+#include "kangsw/markup/utility/timestamp.hxx"
+
+using kangsw::refl::timestamp_t;
+
+static char* format_libc(char* buf, timestamp_t t) {
+    using namespace std::chrono;
+    auto time = timestamp_t::clock::to_time_t(t);
+    tm tm;
+#if _WIN32
+    gmtime_s(&tm, &time);
+#else
+    gmtime_r(&time, &tm);
+#endif
+    int frac = duration_cast<milliseconds>(t.time_since_epoch()).count() % 1000;
+    return buf + snprintf(buf, 25, "%4d-%02d-%02dT%02d:%02d:%02d.%03dZ", tm.tm_year + 1900, tm.tm_mon + 1,
+                          tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, frac);
+}
+
+static bool parse_libc(char const* begin, timestamp_t& out) {
+    tm tm{};
+    std::pair<int*, int> const fields[] = {{&tm.tm_year, 0}, {&tm.tm_mon, 5}, {&tm.tm_mday, 8},
+                                           {&tm.tm_hour, 11}, {&tm.tm_min, 14}, {&tm.tm_sec, 17}};
+    for (auto [field, pos] : fields) {
+        if (std::from_chars(begin + pos, begin + pos + (pos ? 2 : 4), *field).ec != std::errc{}) { return false; }
+    }
+    tm.tm_year -= 1900, tm.tm_mon -= 1;
+
+    int millis = 0;
+    std::from_chars(begin + 20, begin + 23, millis);
+#if _WIN32
+    out = timestamp_t::clock::from_time_t(_mkgmtime(&tm)) + std::chrono::milliseconds{millis};
+#else
+    out = timestamp_t::clock::from_time_t(timegm(&tm)) + std::chrono::milliseconds{millis};
+#endif
+    return true;
+}
+
+int main() {
+    constexpr int num_stamps     = 1000000;
+    constexpr int num_iterations = 5;
+
+    // records of a log stream, which are a few milliseconds apart; and ones scattered over years.
+    std::vector<timestamp_t> sequential, scattered;
+    auto const now = std::chrono::floor<std::chrono::milliseconds>(timestamp_t::clock::now());
+    for (int i = 0; i < num_stamps; ++i) {
+        sequential.push_back(now + std::chrono::milliseconds{i * 7});
+        scattered.push_back(now - std::chrono::hours{(i * 7919LL) % (24 * 365 * 30)});
+    }
+
+    size_t checksum = 0;
+    char buf[kangsw::timestamp::max_formatted_size];
+    auto const run  = [&](std::vector<timestamp_t> const& stamps, auto&& format) {
+        return measure(num_iterations, [&] {
+            for (auto& t : stamps) { checksum += format(buf, t) - buf; }
+        });
+    };
+
+    printf("%-12s %-16s %10s %12s\n", "input", "method", "ms", "Mstamps/s");
+    for (auto& [name, stamps] : {std::pair{"sequential", &sequential}, std::pair{"scattered", &scattered}}) {
+        auto const libc = run(*stamps, format_libc);
+        printf("%-12s %-16s %10.2f %12.2f\n", name, "gmtime+snprintf", libc, num_stamps / libc / 1e3);
+
+        for (int digits : {3, 6, 9}) {
+            auto const ms = run(*stamps, [digits](char* b, timestamp_t t) { return kangsw::timestamp::format(b, t, digits); });
+            char method[32];
+            snprintf(method, sizeof method, "format(%d)", digits);
+            printf("%-12s %-16s %10.2f %12.2f\n", name, method, ms, num_stamps / ms / 1e3);
+        }
+    }
+
+    std::vector<std::string> texts;
+    for (auto& t : scattered) { texts.emplace_back(buf, kangsw::timestamp::format(buf, t)); }
+
+    timestamp_t parsed;
+    auto const libc = measure(num_iterations, [&] {
+        for (auto& s : texts) { checksum += parse_libc(s.data(), parsed); }
+    });
+    auto const fast = measure(num_iterations, [&] {
+        for (auto& s : texts) { checksum += kangsw::timestamp::parse(s.data(), s.data() + s.size(), parsed) != nullptr; }
+    });
+    printf("%-12s %-16s %10.2f %12.2f\n", "parse", "from_chars+timegm", libc, num_stamps / libc / 1e3);
+    printf("%-12s %-16s %10.2f %12.2f\n", "parse", "parse", fast, num_stamps / fast / 1e3);
+    printf("(checksum %zu)\n", checksum);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <chrono>
+#include <ratio>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Runs fn num_iterations times, then returns average elapsed time of single run in Unit_, which
+ *is milliseconds by default. fn may optionally take index of current iteration.
+ */
+template <typename Unit_ = std::milli, typename Fn_>
+double measure(int num_iterations, Fn_&& fn) {
+    using namespace std::chrono;
+    auto begin = steady_clock::now();
+    for (int iter = 0; iter < num_iterations; ++iter) {
+        if constexpr (std::is_invocable_v<Fn_&, int>) {
+            fn(iter);
+        } else {
+            fn();
+        }
+    }
+
+    return duration<double, Unit_>(steady_clock::now() - begin).count() / num_iterations;
+}
+
+/** Elapsed time of single run of fn, in Unit_. */
+template <typename Unit_ = std::milli, typename Fn_>
+double measure(Fn_&& fn) { return measure<Unit_>(1, std::forward<Fn_>(fn)); }